@@ -58,6 +58,14 @@ ifeq (${ENABLE_PMF}, 1)
 BL31_SOURCES		+=	lib/pmf/pmf_main.c
 endif
 
+ifeq (${ENABLE_RT_SVC_STATS}, 1)
+BL31_SOURCES		+=	bl31/runtime_svc_stats.c
+endif
+
+ifeq (${ENABLE_TRACE_LOG}, 1)
+BL31_SOURCES		+=	lib/trace_log/trace_log.c
+endif
+
 include lib/debugfs/debugfs.mk
 ifeq (${USE_DEBUGFS},1)
 	BL31_SOURCES	+= $(DEBUGFS_SRCS)
@@ -21,6 +21,7 @@
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
+#include <lib/trace_log/trace_log.h>
 #include <plat/common/platform.h>
 #include <services/std_svc.h>
 
@@ -129,6 +130,10 @@ void bl31_main(void)
 	detect_arch_features();
 #endif /* FEATURE_DETECTION */
 
+#if ENABLE_TRACE_LOG
+	trace_log_init();
+#endif
+
 #if ENABLE_RUNTIME_INSTRUMENTATION
 	PMF_CAPTURE_TIMESTAMP(bl_svc, BL31_ENTRY, PMF_CACHE_MAINT);
 #endif
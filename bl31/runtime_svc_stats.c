@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <platform_def.h>
+
+#include <arch_helpers.h>
+#include <bl31/runtime_svc_stats.h>
+#include <common/runtime_svc.h>
+#include <lib/pmf/pmf.h>
+#include <plat/common/platform.h>
+
+typedef struct rt_svc_stats {
+	uint64_t calls;
+	uint64_t ticks;
+	uint32_t buckets[RT_SVC_STATS_BUCKETS];
+} rt_svc_stats_t;
+
+/* Statistics of each CPU, only updated by that CPU */
+static struct {
+	rt_svc_stats_t svc[PLAT_RT_SVC_STATS_MAX_SVCS];
+} __aligned(CACHE_WRITEBACK_GRANULE) rt_svc_stats[PLATFORM_CORE_COUNT];
+
+/*
+ * Account for an SMC handled by the runtime service 'index' in the
+ * 'rt_svc_descs' array, whose handler was called at time 'start'.
+ */
+void rt_svc_stats_record(unsigned int index, uint64_t start)
+{
+	uint64_t ticks = read_cntpct_el0() - start;
+	uint64_t scaled = ticks >> RT_SVC_STATS_BUCKET_SHIFT;
+	unsigned int bucket = 0U;
+	rt_svc_stats_t *stats;
+
+	if (index >= PLAT_RT_SVC_STATS_MAX_SVCS) {
+		return;
+	}
+
+	if (scaled != 0ULL) {
+		bucket = 64U - (unsigned int)__builtin_clzll(scaled);
+		if (bucket >= RT_SVC_STATS_BUCKETS) {
+			bucket = RT_SVC_STATS_BUCKETS - 1U;
+		}
+	}
+
+	stats = &rt_svc_stats[plat_my_core_pos()].svc[index];
+	stats->calls++;
+	stats->ticks += ticks;
+	stats->buckets[bucket]++;
+}
+
+/* PMF handler returning a counter of a CPU, see runtime_svc_stats.h */
+static unsigned long long rt_svc_stats_get(unsigned int tid,
+					   u_register_t mpidr,
+					   unsigned int flags)
+{
+	unsigned int counter = tid & PMF_TID_MASK;
+	unsigned int oen = (tid >> RT_SVC_STATS_OEN_SHIFT) &
+			   RT_SVC_STATS_OEN_MASK;
+	const rt_svc_stats_t *stats;
+	unsigned int index;
+	int cpu;
+
+	/* The PMF framework already checked both */
+	cpu = plat_core_pos_by_mpidr(mpidr);
+	assert((cpu >= 0) && (counter < RT_SVC_STATS_TOTAL_IDS));
+
+	index = rt_svc_descs_indices[oen];
+	if (index >= PLAT_RT_SVC_STATS_MAX_SVCS) {
+		/* Not a registered service, or no statistics kept for it */
+		return 0ULL;
+	}
+
+	stats = &rt_svc_stats[cpu].svc[index];
+
+	switch (counter) {
+	case RT_SVC_STATS_CALLS:
+		return stats->calls;
+	case RT_SVC_STATS_TICKS:
+		return stats->ticks;
+	default:
+		return stats->buckets[counter - RT_SVC_STATS_BUCKET(0U)];
+	}
+}
+
+PMF_REGISTER_SERVICE_SMC_OWN(rt_svc_stats, PMF_ARM_TIF_IMPL_ID,
+			     PMF_RT_SVC_STATS_SVC_ID, RT_SVC_STATS_TOTAL_IDS,
+			     NULL, rt_svc_stats_get)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -14,6 +14,7 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
+#include <drivers/auth/crypto_mod.h>
 #include <drivers/io/io_storage.h>
 #include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_defs.h>
@@ -47,6 +48,70 @@ static int dyn_is_auth_disabled(void)
 }
 #endif /* TRUSTED_BOARD_BOOT */
 
+#if HASH_IMAGE_ON_LOAD
+/* Size of the chunks in which images are read and hashed */
+#define IMAGE_HASH_CHUNK_SIZE	U(0x10000)
+
+/*
+ * Read an image chunk by chunk and feed each chunk to the crypto module while
+ * it is still hot in the cache. The crypto module keeps the resulting digest,
+ * so verifying or measuring the image afterwards does not need another pass
+ * over it.
+ *
+ * The io_encrypted driver decrypts and authenticates an image in a single
+ * read, so encrypted images are read in one go and hashed later as usual.
+ */
+static int read_image(unsigned int image_id, uintptr_t dev_handle,
+		      uintptr_t image_handle, uintptr_t image_base,
+		      size_t image_size, size_t *bytes_read)
+{
+	unsigned char digest[CRYPTO_MD_MAX_SIZE];
+	size_t offset = 0U;
+	size_t chunk_read;
+	int io_result = 0;
+
+	if (io_dev_get_type(dev_handle) == IO_TYPE_ENCRYPTED) {
+		return io_read(image_handle, image_base, image_size,
+			       bytes_read);
+	}
+
+	crypto_mod_digest_select(image_id);
+
+	if (crypto_mod_hash_init(HASH_IMAGE_ON_LOAD_ALG) != CRYPTO_SUCCESS) {
+		return io_read(image_handle, image_base, image_size,
+			       bytes_read);
+	}
+
+	while (offset < image_size) {
+		io_result = io_read(image_handle, image_base + offset,
+				    MIN(image_size - offset,
+					(size_t)IMAGE_HASH_CHUNK_SIZE),
+				    &chunk_read);
+		if ((io_result != 0) || (chunk_read == 0U)) {
+			break;
+		}
+
+		(void)crypto_mod_hash_update((void *)(image_base + offset),
+					     (unsigned int)chunk_read);
+		offset += chunk_read;
+	}
+
+	/* A digest is only kept if the whole image was hashed */
+	(void)crypto_mod_hash_finish(digest);
+
+	*bytes_read = offset;
+
+	return io_result;
+}
+#else
+static inline int read_image(unsigned int image_id, uintptr_t dev_handle,
+			     uintptr_t image_handle, uintptr_t image_base,
+			     size_t image_size, size_t *bytes_read)
+{
+	return io_read(image_handle, image_base, image_size, bytes_read);
+}
+#endif /* HASH_IMAGE_ON_LOAD */
+
 uintptr_t page_align(uintptr_t value, unsigned dir)
 {
 	/* Round up the limit to the next page boundary */
@@ -123,7 +188,8 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	/* We have enough space so load the image now */
 	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
+	io_result = read_image(image_id, dev_handle, image_handle, image_base,
+			       image_size, &bytes_read);
 	if ((io_result != 0) || (bytes_read < image_size)) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
@@ -190,6 +256,15 @@ static int load_auth_image_recursive(unsigned int image_id,
 static int load_auth_image_internal(unsigned int image_id,
 				    image_info_t *image_data)
 {
+#if CRYPTO_SUPPORT
+	/*
+	 * Keep the digests calculated while loading and authenticating the
+	 * image so that measuring it does not hash it again. Digests from a
+	 * previous attempt to load the image are dropped.
+	 */
+	crypto_mod_digest_begin();
+#endif
+
 #if TRUSTED_BOARD_BOOT
 	if (dyn_is_auth_disabled() == 0) {
 		return load_auth_image_recursive(image_id, image_data, 0);
@@ -230,18 +305,22 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 		 * it (if MEASURED_BOOT flag is enabled).
 		 */
 		err = plat_mboot_measure_image(image_id, image_data);
-		if (err != 0) {
-			return err;
+		if (err == 0) {
+			/*
+			 * Flush the image to main memory so that it can be
+			 * executed later by any CPU, regardless of cache and
+			 * MMU state.
+			 */
+			flush_dcache_range(image_data->image_base,
+					   image_data->image_size);
 		}
-
-		/*
-		 * Flush the image to main memory so that it can be executed
-		 * later by any CPU, regardless of cache and MMU state.
-		 */
-		flush_dcache_range(image_data->image_base,
-				   image_data->image_size);
 	}
 
+#if CRYPTO_SUPPORT
+	/* The image may be modified from now on, drop its cached digests */
+	crypto_mod_digest_forget();
+#endif
+
 	return err;
 }
 
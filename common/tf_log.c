@@ -9,6 +9,7 @@
 #include <stdio.h>
 
 #include <common/debug.h>
+#include <drivers/console.h>
 #include <plat/common/platform.h>
 
 /* Set the default maximum log level to the `LOG_LEVEL` build flag */
@@ -47,6 +48,11 @@ void tf_log(const char *fmt, ...)
 	va_start(args, fmt);
 	(void)vprintf(fmt + 1, args);
 	va_end(args);
+
+	/* Errors and warnings are not left in the console buffer */
+	if (log_level <= LOG_LEVEL_WARNING) {
+		console_drain();
+	}
 }
 
 void tf_log_newline(const char log_fmt[2])
@@ -10,6 +10,7 @@
 
 #include <platform_def.h>
 
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <common/tbbr/cot_def.h>
 #include <drivers/auth/auth_common.h>
@@ -33,6 +34,123 @@
 	} while (0)
 
 #pragma weak plat_set_nv_ctr2
+#pragma weak plat_get_auth_cert_cache
+
+#if AUTH_CERT_CACHE
+/* Certificates verified by this boot stage and the previous ones */
+static auth_cert_cache_t auth_cert_cache;
+
+/*
+ * Calculate the digest identifying a certificate verified with a public key.
+ * The length of the certificate is hashed first so that the boundary between
+ * the certificate and the key cannot be moved.
+ */
+static int auth_cert_digest(void *img, unsigned int img_len,
+			    void *pk_ptr, unsigned int pk_len,
+			    unsigned char digest[CRYPTO_MD_MAX_SIZE])
+{
+	int rc, rc_finish;
+
+	(void)memset(digest, 0, CRYPTO_MD_MAX_SIZE);
+
+	rc = crypto_mod_hash_init(AUTH_CERT_CACHE_ALG);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	rc = crypto_mod_hash_update(&img_len, sizeof(img_len));
+	if (rc == CRYPTO_SUCCESS) {
+		rc = crypto_mod_hash_update(img, img_len);
+	}
+	if (rc == CRYPTO_SUCCESS) {
+		rc = crypto_mod_hash_update(pk_ptr, pk_len);
+	}
+
+	rc_finish = crypto_mod_hash_finish(digest);
+
+	return (rc != CRYPTO_SUCCESS) ? rc : rc_finish;
+}
+
+static bool auth_cert_cache_lookup(unsigned int img_id,
+				   const unsigned char *digest)
+{
+	unsigned int i;
+
+	for (i = 0U; i < auth_cert_cache.count; i++) {
+		if ((auth_cert_cache.entries[i].img_id == img_id) &&
+		    (memcmp(auth_cert_cache.entries[i].digest, digest,
+			    CRYPTO_MD_MAX_SIZE) == 0)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void auth_cert_cache_add(unsigned int img_id,
+				const unsigned char *digest)
+{
+	unsigned int i = auth_cert_cache.count;
+
+	/* Once full, keep the certificates closest to the root of trust */
+	if (i == PLAT_AUTH_CERT_CACHE_ENTRIES) {
+		return;
+	}
+
+	auth_cert_cache.entries[i].img_id = img_id;
+	(void)memcpy(auth_cert_cache.entries[i].digest, digest,
+		     CRYPTO_MD_MAX_SIZE);
+	auth_cert_cache.count = i + 1U;
+
+	/* The next boot stage may read the cache with its MMU off */
+	flush_dcache_range((uintptr_t)&auth_cert_cache,
+			   sizeof(auth_cert_cache));
+}
+
+/*
+ * Take over the certificates verified by the previous boot stage. They are
+ * copied as the memory of the previous stage may be overwritten by images
+ * before they are authenticated.
+ */
+static void auth_cert_cache_import(void)
+{
+	const auth_cert_cache_t *prev_cache;
+	void *cache_addr = NULL;
+	size_t cache_size = 0U;
+
+	auth_cert_cache.magic = AUTH_CERT_CACHE_MAGIC;
+	auth_cert_cache.count = 0U;
+
+	if ((plat_get_auth_cert_cache(&cache_addr, &cache_size) != 0) ||
+	    (cache_addr == NULL) || (cache_size != sizeof(auth_cert_cache))) {
+		return;
+	}
+
+	prev_cache = cache_addr;
+	if ((prev_cache->magic != AUTH_CERT_CACHE_MAGIC) ||
+	    (prev_cache->count > PLAT_AUTH_CERT_CACHE_ENTRIES)) {
+		return;
+	}
+
+	(void)memcpy(&auth_cert_cache, prev_cache, sizeof(auth_cert_cache));
+
+	VERBOSE("AUTH: %u verified certificates handed over\n",
+		auth_cert_cache.count);
+}
+
+/*
+ * Return the cache of verified certificates, so that the platform can hand
+ * it over to the next boot stage.
+ */
+void auth_mod_get_cert_cache(void **cache_addr, size_t *cache_size)
+{
+	assert(cache_addr != NULL);
+	assert(cache_size != NULL);
+
+	*cache_addr = &auth_cert_cache;
+	*cache_size = sizeof(auth_cert_cache);
+}
+#endif /* AUTH_CERT_CACHE */
 
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
@@ -154,6 +272,10 @@ static int auth_signature(const auth_method_param_sig_t *param,
 	unsigned int data_len, pk_len, pk_plat_len, sig_len, sig_alg_len;
 	unsigned int flags = 0;
 	int rc = 0;
+#if AUTH_CERT_CACHE
+	unsigned char cert_digest[CRYPTO_MD_MAX_SIZE];
+	bool cacheable;
+#endif
 
 	/* Get the data to be signed from current image */
 	rc = img_parser_get_auth_param(img_desc->img_type, param->data,
@@ -249,12 +371,31 @@ static int auth_signature(const auth_method_param_sig_t *param,
 		}
 	}
 
+#if AUTH_CERT_CACHE
+	/*
+	 * Skip the public key operation if this certificate was already
+	 * verified with the same key, by this boot stage or a previous one.
+	 */
+	cacheable = (auth_cert_digest(img, img_len, pk_ptr, pk_len,
+				      cert_digest) == CRYPTO_SUCCESS);
+	if (cacheable && auth_cert_cache_lookup(img_desc->img_id,
+						cert_digest)) {
+		return 0;
+	}
+#endif
+
 	/* Ask the crypto module to verify the signature */
 	rc = crypto_mod_verify_signature(data_ptr, data_len,
 					 sig_ptr, sig_len,
 					 sig_alg_ptr, sig_alg_len,
 					 pk_ptr, pk_len);
 
+#if AUTH_CERT_CACHE
+	if ((rc == 0) && cacheable) {
+		auth_cert_cache_add(img_desc->img_id, cert_digest);
+	}
+#endif
+
 	return rc;
 }
 
@@ -350,6 +491,13 @@ int plat_set_nv_ctr2(void *cookie, const auth_img_desc_t *img_desc __unused,
 	return plat_set_nv_ctr(cookie, nv_ctr);
 }
 
+int plat_get_auth_cert_cache(void **cache_addr __unused,
+			     size_t *cache_size __unused)
+{
+	/* No cache handed over by the previous boot stage */
+	return -1;
+}
+
 /*
  * Return the parent id in the output parameter '*parent_id'
  *
@@ -390,6 +538,10 @@ void auth_mod_init(void)
 
 	/* Image parser module */
 	img_parser_init();
+
+#if AUTH_CERT_CACHE
+	auth_cert_cache_import();
+#endif
 }
 
 /*
@@ -419,6 +571,9 @@ int auth_mod_verify_img(unsigned int img_id,
 	rc = img_parser_check_integrity(img_desc->img_type, img_ptr, img_len);
 	return_if_error(rc);
 
+	/* Hashes calculated from now on are those of this image */
+	crypto_mod_digest_select(img_id);
+
 	/* Authenticate the image using the methods indicated in the image
 	 * descriptor. */
 	if (img_desc->img_auth_methods == NULL)
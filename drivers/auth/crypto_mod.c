@@ -5,6 +5,9 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 
 #include <common/debug.h>
 #include <drivers/auth/crypto_mod.h>
@@ -64,6 +67,46 @@ CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 	INFO("Using crypto library '%s'\n", crypto_lib_desc.name);
 }
 
+/* Number of digests kept by the digest cache */
+#define DIGEST_CACHE_ENTRIES	4U
+
+/*
+ * Cache of the digests of the images that were verified or hashed during the
+ * current load operation, so that an image is not hashed again to measure it.
+ * The cache is only in use between crypto_mod_digest_begin() and
+ * crypto_mod_digest_forget(). An entry is only returned for exactly the same
+ * image ID, memory region and algorithm.
+ */
+static struct {
+	unsigned int image_id;
+	enum crypto_md_algo alg;
+	uintptr_t base;
+	size_t len;
+	bool valid;
+	unsigned char digest[CRYPTO_MD_MAX_SIZE];
+} digest_cache[DIGEST_CACHE_ENTRIES];
+
+/* Next cache entry to be replaced */
+static unsigned int digest_cache_next;
+
+/* Whether the digest cache is in use */
+static bool digest_cache_enabled;
+
+/* Image that digests are being recorded for */
+static unsigned int digest_image_id;
+
+/* State of the incremental hash calculation */
+static struct {
+	enum crypto_md_algo alg;
+	uintptr_t base;
+	size_t len;
+	bool active;
+	bool contiguous;
+} hash_stream;
+
+/* Whether an incremental authenticated decryption is in progress */
+static bool auth_decrypt_active;
+
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
 CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 /*
@@ -137,11 +180,251 @@ int crypto_mod_calc_hash(enum crypto_md_algo alg, void *data_ptr,
 	assert(data_len != 0);
 	assert(output != NULL);
 
+	if (crypto_mod_digest_lookup(CRYPTO_DIGEST_SELECTED_ID, alg, data_ptr,
+				     data_len, output) == 0) {
+		return CRYPTO_SUCCESS;
+	}
+
 	return crypto_lib_desc.calc_hash(alg, data_ptr, data_len, output);
 }
 #endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
+/*
+ * Start an incremental hash calculation. Its digest is added to the digest
+ * cache if the data is fed as one contiguous memory region.
+ *
+ * Parameters:
+ *
+ *   alg: message digest algorithm
+ */
+int crypto_mod_hash_init(enum crypto_md_algo alg)
+{
+	int rc;
+
+	assert(!hash_stream.active);
+
+	if ((crypto_lib_desc.hash_init == NULL) ||
+	    (crypto_lib_desc.hash_update == NULL) ||
+	    (crypto_lib_desc.hash_finish == NULL)) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	rc = crypto_lib_desc.hash_init(alg);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	hash_stream.alg = alg;
+	hash_stream.base = 0U;
+	hash_stream.len = 0U;
+	hash_stream.active = true;
+	hash_stream.contiguous = true;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Feed data to the incremental hash calculation
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: data to be hashed
+ */
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	assert(hash_stream.active);
+	assert(data_ptr != NULL);
+
+	if (data_len == 0U) {
+		return CRYPTO_SUCCESS;
+	}
+
+	if (hash_stream.len == 0U) {
+		hash_stream.base = (uintptr_t)data_ptr;
+	} else if ((hash_stream.base + hash_stream.len) !=
+		   (uintptr_t)data_ptr) {
+		hash_stream.contiguous = false;
+	}
+
+	rc = crypto_lib_desc.hash_update(data_ptr, data_len);
+	if (rc != CRYPTO_SUCCESS) {
+		/* The digest can no longer be trusted */
+		hash_stream.contiguous = false;
+		return rc;
+	}
+
+	hash_stream.len += data_len;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Finish the incremental hash calculation. This must be called once for each
+ * successful crypto_mod_hash_init(), even after a failed update.
+ *
+ * Parameters:
+ *
+ *   output: resulting hash
+ */
+int crypto_mod_hash_finish(unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	int rc;
+
+	assert(hash_stream.active);
+	assert(output != NULL);
+
+	hash_stream.active = false;
+
+	rc = crypto_lib_desc.hash_finish(output);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	if (hash_stream.contiguous && (hash_stream.len != 0U)) {
+		crypto_mod_digest_record(hash_stream.alg,
+					 (const void *)hash_stream.base,
+					 (unsigned int)hash_stream.len, output);
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Empty the digest cache and start recording digests into it. This must be
+ * balanced by crypto_mod_digest_forget() before the hashed data may be
+ * modified.
+ */
+void crypto_mod_digest_begin(void)
+{
+	crypto_mod_digest_forget();
+
+	digest_cache_enabled = true;
+}
+
+/*
+ * Select the image that the digests recorded from now on belong to
+ *
+ * Parameters:
+ *
+ *   image_id: image identifier
+ */
+void crypto_mod_digest_select(unsigned int image_id)
+{
+	assert(image_id != CRYPTO_DIGEST_SELECTED_ID);
+
+	digest_image_id = image_id;
+}
+
+/*
+ * Add the digest of a memory region to the digest cache, on behalf of the
+ * image last selected by crypto_mod_digest_select(). Crypto libraries call
+ * this for every hash they successfully verify. Nothing is recorded unless
+ * the cache is in use.
+ *
+ * Parameters:
+ *
+ *   alg: message digest algorithm
+ *   data_ptr, data_len: hashed data
+ *   digest: hash of the data
+ */
+void crypto_mod_digest_record(enum crypto_md_algo alg, const void *data_ptr,
+			      unsigned int data_len,
+			      const unsigned char digest[CRYPTO_MD_MAX_SIZE])
+{
+	unsigned int i;
+
+	assert(data_ptr != NULL);
+	assert(digest != NULL);
+
+	if (!digest_cache_enabled ||
+	    (digest_image_id == CRYPTO_DIGEST_SELECTED_ID)) {
+		return;
+	}
+
+	/* Replace the entry for the same data, if any */
+	for (i = 0U; i < DIGEST_CACHE_ENTRIES; i++) {
+		if (digest_cache[i].valid &&
+		    (digest_cache[i].alg == alg) &&
+		    (digest_cache[i].base == (uintptr_t)data_ptr) &&
+		    (digest_cache[i].len == data_len)) {
+			break;
+		}
+	}
+
+	if (i == DIGEST_CACHE_ENTRIES) {
+		i = digest_cache_next;
+		digest_cache_next = (digest_cache_next + 1U) %
+				    DIGEST_CACHE_ENTRIES;
+	}
+
+	digest_cache[i].image_id = digest_image_id;
+	digest_cache[i].alg = alg;
+	digest_cache[i].base = (uintptr_t)data_ptr;
+	digest_cache[i].len = data_len;
+	(void)memcpy(digest_cache[i].digest, digest, CRYPTO_MD_MAX_SIZE);
+	digest_cache[i].valid = true;
+}
+
+/*
+ * Retrieve the digest of a memory region from the digest cache.
+ * Returns 0 on success, -1 if no such digest is available.
+ *
+ * Parameters:
+ *
+ *   image_id: image the digest was recorded for, or
+ *             CRYPTO_DIGEST_SELECTED_ID for the image currently selected
+ *   alg: message digest algorithm
+ *   data_ptr, data_len: hashed data
+ *   output: resulting hash
+ */
+int crypto_mod_digest_lookup(unsigned int image_id, enum crypto_md_algo alg,
+			     const void *data_ptr, unsigned int data_len,
+			     unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	unsigned int i;
+
+	assert(output != NULL);
+
+	if (!digest_cache_enabled) {
+		return -1;
+	}
+
+	if (image_id == CRYPTO_DIGEST_SELECTED_ID) {
+		image_id = digest_image_id;
+	}
+
+	for (i = 0U; i < DIGEST_CACHE_ENTRIES; i++) {
+		if (digest_cache[i].valid &&
+		    (digest_cache[i].image_id == image_id) &&
+		    (digest_cache[i].alg == alg) &&
+		    (digest_cache[i].base == (uintptr_t)data_ptr) &&
+		    (digest_cache[i].len == data_len)) {
+			(void)memcpy(output, digest_cache[i].digest,
+				     CRYPTO_MD_MAX_SIZE);
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+/* Empty the digest cache and stop recording digests */
+void crypto_mod_digest_forget(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < DIGEST_CACHE_ENTRIES; i++) {
+		digest_cache[i].valid = false;
+	}
+
+	digest_cache_next = 0U;
+	digest_image_id = CRYPTO_DIGEST_SELECTED_ID;
+	digest_cache_enabled = false;
+}
+
 int crypto_mod_convert_pk(void *full_pk_ptr, unsigned int full_pk_len,
 			  void **hashed_pk_ptr, unsigned int *hashed_pk_len)
 {
@@ -187,3 +470,87 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 					    key_len, key_flags, iv, iv_len, tag,
 					    tag_len);
 }
+
+/*
+ * Start an incremental authenticated decryption. The data is then decrypted in
+ * place by successive calls to crypto_mod_auth_decrypt_update() and must not
+ * be used before crypto_mod_auth_decrypt_finish() succeeded. All the chunks
+ * but the last must be a multiple of the block size of the cipher.
+ *
+ * Return CRYPTO_ERR_INIT if the cryptographic library cannot decrypt
+ * incrementally, crypto_mod_auth_decrypt() must then be used.
+ *
+ * Parameters:
+ *
+ *   dec_algo: authenticated decryption algorithm
+ *   key, key_len, key_flags: symmetric decryption key
+ *   iv, iv_len: initialization vector
+ */
+int crypto_mod_auth_decrypt_init(enum crypto_dec_algo dec_algo,
+				 const void *key, unsigned int key_len,
+				 unsigned int key_flags, const void *iv,
+				 unsigned int iv_len)
+{
+	int rc;
+
+	assert(!auth_decrypt_active);
+	assert(key != NULL);
+	assert(key_len != 0U);
+	assert(iv != NULL);
+	assert((iv_len != 0U) && (iv_len <= CRYPTO_MAX_IV_SIZE));
+
+	if ((crypto_lib_desc.auth_decrypt_init == NULL) ||
+	    (crypto_lib_desc.auth_decrypt_update == NULL) ||
+	    (crypto_lib_desc.auth_decrypt_finish == NULL)) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	rc = crypto_lib_desc.auth_decrypt_init(dec_algo, key, key_len,
+					       key_flags, iv, iv_len);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	auth_decrypt_active = true;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Decrypt the next chunk of data of the incremental authenticated decryption
+ *
+ * Parameters:
+ *
+ *   data_ptr, len: data to be decrypted (inout param)
+ */
+int crypto_mod_auth_decrypt_update(void *data_ptr, size_t len)
+{
+	assert(auth_decrypt_active);
+	assert(data_ptr != NULL);
+
+	if (len == 0U) {
+		return CRYPTO_SUCCESS;
+	}
+
+	return crypto_lib_desc.auth_decrypt_update(data_ptr, len);
+}
+
+/*
+ * Finish the incremental authenticated decryption and check the tag. This must
+ * be called once for each successful crypto_mod_auth_decrypt_init(), even
+ * after a failed update.
+ *
+ * Parameters:
+ *
+ *   tag, tag_len: authentication tag
+ */
+int crypto_mod_auth_decrypt_finish(const void *tag, unsigned int tag_len)
+{
+	assert(auth_decrypt_active);
+	assert(tag != NULL);
+	assert((tag_len != 0U) && (tag_len <= CRYPTO_MAX_TAG_SIZE));
+
+	auth_decrypt_active = false;
+
+	return crypto_lib_desc.auth_decrypt_finish(tag, tag_len);
+}
@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -54,6 +55,47 @@ CASSERT(CRYPTO_MD_MAX_SIZE >= MBEDTLS_MD_MAX_SIZE,
  * }
  */
 
+/*
+ * Map a generic crypto message digest algorithm to the corresponding macro used
+ * by Mbed TLS.
+ */
+static inline mbedtls_md_type_t md_type(enum crypto_md_algo algo)
+{
+	switch (algo) {
+	case CRYPTO_MD_SHA512:
+		return MBEDTLS_MD_SHA512;
+	case CRYPTO_MD_SHA384:
+		return MBEDTLS_MD_SHA384;
+	case CRYPTO_MD_SHA256:
+		return MBEDTLS_MD_SHA256;
+	default:
+		/* Invalid hash algorithm. */
+		return MBEDTLS_MD_NONE;
+	}
+}
+
+/*
+ * Map an Mbed TLS message digest type to the corresponding generic crypto
+ * algorithm. Returns -1 for algorithms unknown to the crypto module.
+ */
+static inline int crypto_md_algo(mbedtls_md_type_t type,
+				 enum crypto_md_algo *algo)
+{
+	switch (type) {
+	case MBEDTLS_MD_SHA512:
+		*algo = CRYPTO_MD_SHA512;
+		return 0;
+	case MBEDTLS_MD_SHA384:
+		*algo = CRYPTO_MD_SHA384;
+		return 0;
+	case MBEDTLS_MD_SHA256:
+		*algo = CRYPTO_MD_SHA256;
+		return 0;
+	default:
+		return -1;
+	}
+}
+
 /*
  * Initialize the library and export the descriptor
  */
@@ -165,9 +207,12 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
+	enum crypto_md_algo algo;
+	bool known_algo;
+	bool record = false;
 	const mbedtls_md_info_t *md_info;
 	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char data_hash[CRYPTO_MD_MAX_SIZE];
 	size_t len;
 	int rc;
 
@@ -214,11 +259,20 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 	hash = p;
 
-	/* Calculate the hash of the data */
+	/*
+	 * Calculate the hash of the data, unless it is in the digest cache
+	 * already, e.g. because it was calculated while the data was loaded.
+	 */
 	p = (unsigned char *)data_ptr;
-	rc = mbedtls_md(md_info, p, data_len, data_hash);
-	if (rc != 0) {
-		return CRYPTO_ERR_HASH;
+	known_algo = (crypto_md_algo(md_alg, &algo) == 0);
+	if (!known_algo ||
+	    (crypto_mod_digest_lookup(CRYPTO_DIGEST_SELECTED_ID, algo, p,
+				      data_len, data_hash) != 0)) {
+		rc = mbedtls_md(md_info, p, data_len, data_hash);
+		if (rc != 0) {
+			return CRYPTO_ERR_HASH;
+		}
+		record = known_algo;
 	}
 
 	/* Compare values */
@@ -227,6 +281,11 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
+	/* Let measured boot reuse the verified hash of the data */
+	if (record) {
+		crypto_mod_digest_record(algo, p, data_len, data_hash);
+	}
+
 	return CRYPTO_SUCCESS;
 }
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
@@ -234,25 +293,6 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 
 #if CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
-/*
- * Map a generic crypto message digest algorithm to the corresponding macro used
- * by Mbed TLS.
- */
-static inline mbedtls_md_type_t md_type(enum crypto_md_algo algo)
-{
-	switch (algo) {
-	case CRYPTO_MD_SHA512:
-		return MBEDTLS_MD_SHA512;
-	case CRYPTO_MD_SHA384:
-		return MBEDTLS_MD_SHA384;
-	case CRYPTO_MD_SHA256:
-		return MBEDTLS_MD_SHA256;
-	default:
-		/* Invalid hash algorithm. */
-		return MBEDTLS_MD_NONE;
-	}
-}
-
 /*
  * Calculate a hash
  *
@@ -279,6 +319,50 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
 #endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
+/*
+ * Incremental hash calculation. A single calculation is in progress at any
+ * time, its context is allocated from the Mbed TLS heap until hash_finish().
+ */
+static mbedtls_md_context_t hash_ctx;
+
+static int hash_init(enum crypto_md_algo md_algo)
+{
+	const mbedtls_md_info_t *md_info;
+
+	md_info = mbedtls_md_info_from_type(md_type(md_algo));
+	if (md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	mbedtls_md_init(&hash_ctx);
+	if ((mbedtls_md_setup(&hash_ctx, md_info, 0) != 0) ||
+	    (mbedtls_md_starts(&hash_ctx) != 0)) {
+		mbedtls_md_free(&hash_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int hash_update(void *data_ptr, unsigned int data_len)
+{
+	if (mbedtls_md_update(&hash_ctx, data_ptr, data_len) != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int hash_finish(unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	int rc;
+
+	rc = mbedtls_md_finish(&hash_ctx, output);
+	mbedtls_md_free(&hash_ctx);
+
+	return (rc == 0) ? CRYPTO_SUCCESS : CRYPTO_ERR_HASH;
+}
+
 #if TF_MBEDTLS_USE_AES_GCM
 /*
  * Stack based buffer allocation for decryption operation. It could
@@ -286,50 +370,57 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
  */
 #define DEC_OP_BUF_SIZE		128
 
-static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
-			   unsigned int key_len, const void *iv,
-			   unsigned int iv_len, const void *tag,
-			   unsigned int tag_len)
+/* Context of the AES-GCM decryption in progress */
+static mbedtls_gcm_context gcm_ctx;
+
+static int aes_gcm_decrypt_init(const void *key, unsigned int key_len,
+				const void *iv, unsigned int iv_len)
 {
-	mbedtls_gcm_context ctx;
 	mbedtls_cipher_id_t cipher = MBEDTLS_CIPHER_ID_AES;
-	unsigned char buf[DEC_OP_BUF_SIZE];
-	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
-	unsigned char *pt = data_ptr;
-	size_t dec_len;
-	int diff, i, rc;
-	size_t output_length __unused;
+	int rc;
 
-	mbedtls_gcm_init(&ctx);
+	mbedtls_gcm_init(&gcm_ctx);
 
-	rc = mbedtls_gcm_setkey(&ctx, cipher, key, key_len * 8);
+	rc = mbedtls_gcm_setkey(&gcm_ctx, cipher, key, key_len * 8);
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
 		goto exit_gcm;
 	}
 
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len, NULL, 0);
+	rc = mbedtls_gcm_starts(&gcm_ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len,
+				NULL, 0);
 #else
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len);
+	rc = mbedtls_gcm_starts(&gcm_ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len);
 #endif
+
+exit_gcm:
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		mbedtls_gcm_free(&gcm_ctx);
+		return CRYPTO_ERR_DECRYPTION;
 	}
 
+	return CRYPTO_SUCCESS;
+}
+
+static int aes_gcm_decrypt_update(void *data_ptr, size_t len)
+{
+	unsigned char buf[DEC_OP_BUF_SIZE];
+	unsigned char *pt = data_ptr;
+	size_t dec_len;
+	int rc;
+	size_t output_length __unused;
+
 	while (len > 0) {
 		dec_len = MIN(sizeof(buf), len);
 
 #if (MBEDTLS_VERSION_MAJOR < 3)
-		rc = mbedtls_gcm_update(&ctx, dec_len, pt, buf);
+		rc = mbedtls_gcm_update(&gcm_ctx, dec_len, pt, buf);
 #else
-		rc = mbedtls_gcm_update(&ctx, pt, dec_len, buf, sizeof(buf), &output_length);
+		rc = mbedtls_gcm_update(&gcm_ctx, pt, dec_len, buf, sizeof(buf), &output_length);
 #endif
 
 		if (rc != 0) {
-			rc = CRYPTO_ERR_DECRYPTION;
-			goto exit_gcm;
+			return CRYPTO_ERR_DECRYPTION;
 		}
 
 		memcpy(pt, buf, dec_len);
@@ -337,10 +428,19 @@ static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
 		len -= dec_len;
 	}
 
+	return CRYPTO_SUCCESS;
+}
+
+static int aes_gcm_decrypt_finish(const void *tag, unsigned int tag_len)
+{
+	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
+	int diff, i, rc;
+	size_t output_length __unused;
+
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_finish(&ctx, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&gcm_ctx, tag_buf, sizeof(tag_buf));
 #else
-	rc = mbedtls_gcm_finish(&ctx, NULL, 0, &output_length, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&gcm_ctx, NULL, 0, &output_length, tag_buf, sizeof(tag_buf));
 #endif
 
 	if (rc != 0) {
@@ -361,10 +461,32 @@ static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
 	rc = CRYPTO_SUCCESS;
 
 exit_gcm:
-	mbedtls_gcm_free(&ctx);
+	mbedtls_gcm_free(&gcm_ctx);
 	return rc;
 }
 
+static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
+			   unsigned int key_len, const void *iv,
+			   unsigned int iv_len, const void *tag,
+			   unsigned int tag_len)
+{
+	int rc;
+
+	rc = aes_gcm_decrypt_init(key, key_len, iv, iv_len);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	rc = aes_gcm_decrypt_update(data_ptr, len);
+	if (rc != CRYPTO_SUCCESS) {
+		/* Release the decryption context */
+		(void)aes_gcm_decrypt_finish(tag, tag_len);
+		return rc;
+	}
+
+	return aes_gcm_decrypt_finish(tag, tag_len);
+}
+
 /*
  * Authenticated decryption of an image
  */
@@ -391,6 +513,33 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 
 	return CRYPTO_SUCCESS;
 }
+
+/*
+ * Incremental authenticated decryption of an image. AES-GCM is the only
+ * algorithm supported, so the update and finish steps always use it.
+ */
+static int auth_decrypt_init(enum crypto_dec_algo dec_algo, const void *key,
+			     unsigned int key_len, unsigned int key_flags,
+			     const void *iv, unsigned int iv_len)
+{
+	assert((key_flags & ENC_KEY_IS_IDENTIFIER) == 0);
+
+	if (dec_algo != CRYPTO_GCM_DECRYPT) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	return aes_gcm_decrypt_init(key, key_len, iv, iv_len);
+}
+
+static int auth_decrypt_update(void *data_ptr, size_t len)
+{
+	return aes_gcm_decrypt_update(data_ptr, len);
+}
+
+static int auth_decrypt_finish(const void *tag, unsigned int tag_len)
+{
+	return aes_gcm_decrypt_finish(tag, tag_len);
+}
 #endif /* TF_MBEDTLS_USE_AES_GCM */
 
 /*
@@ -398,20 +547,30 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
  */
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB_WITH_STREAMS(LIB_NAME, init, verify_signature,
+				 verify_hash, calc_hash, auth_decrypt, NULL,
+				 hash_init, hash_update, hash_finish,
+				 auth_decrypt_init, auth_decrypt_update,
+				 auth_decrypt_finish);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    NULL, NULL);
+REGISTER_CRYPTO_LIB_WITH_HASH_STREAM(LIB_NAME, init, verify_signature,
+				     verify_hash, calc_hash, NULL, NULL,
+				     hash_init, hash_update, hash_finish);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB_WITH_STREAMS(LIB_NAME, init, verify_signature,
+				 verify_hash, NULL, auth_decrypt, NULL,
+				 hash_init, hash_update, hash_finish,
+				 auth_decrypt_init, auth_decrypt_update,
+				 auth_decrypt_finish);
 #else
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    NULL, NULL);
+REGISTER_CRYPTO_LIB_WITH_HASH_STREAM(LIB_NAME, init, verify_signature,
+				     verify_hash, NULL, NULL, NULL,
+				     hash_init, hash_update, hash_finish);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY
-REGISTER_CRYPTO_LIB(LIB_NAME, init, NULL, NULL, calc_hash, NULL, NULL);
+REGISTER_CRYPTO_LIB_WITH_HASH_STREAM(LIB_NAME, init, NULL, NULL, calc_hash,
+				     NULL, NULL, hash_init, hash_update,
+				     hash_finish);
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
@@ -5,14 +5,59 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 
+#include <platform_def.h>
+
+#include <arch.h>
+#include <arch_helpers.h>
 #include <drivers/console.h>
+#include <drivers/console_buffer.h>
+#include <lib/cassert.h>
+#include <lib/spinlock.h>
+#include <plat/common/platform.h>
 
 console_t *console_list;
 static uint8_t console_state = CONSOLE_FLAG_BOOT;
 
+#if CONSOLE_BUFFERED
+/*
+ * Once BL31 has switched the console to the runtime state, the characters
+ * printed by each CPU are stored in a buffer of its own rather than written to
+ * the consoles right away. The buffer is drained by the same CPU when it goes
+ * idle, when it is half full at the end of a line, or when an error or a
+ * warning is logged. console_flush() drains the buffers of all CPUs, and the
+ * crash reporting drains the buffer of the crashing CPU.
+ *
+ * Only the owning CPU adds characters to a buffer, but any CPU may drain it,
+ * so draining is serialised by console_buffer_lock.
+ */
+CASSERT(IS_POWER_OF_TWO(PLAT_CONSOLE_BUFFER_SIZE),
+	assert_console_buffer_size_power_of_two);
+
+typedef struct console_buffer {
+	/* Free running indexes, the number of buffered characters is head-tail */
+	volatile unsigned int head;
+	volatile unsigned int tail;
+	char data[PLAT_CONSOLE_BUFFER_SIZE];
+} __aligned(CACHE_WRITEBACK_GRANULE) console_buffer_t;
+
+CASSERT(CONSOLE_BUFFER_T_HEAD == __builtin_offsetof(console_buffer_t, head),
+	assert_console_buffer_head_offset_mismatch);
+CASSERT(CONSOLE_BUFFER_T_TAIL == __builtin_offsetof(console_buffer_t, tail),
+	assert_console_buffer_tail_offset_mismatch);
+CASSERT(CONSOLE_BUFFER_T_DATA == __builtin_offsetof(console_buffer_t, data),
+	assert_console_buffer_data_offset_mismatch);
+CASSERT(CONSOLE_BUFFER_T_SIZE == sizeof(console_buffer_t),
+	assert_console_buffer_size_mismatch);
+
+/* Also used by the crash reporting */
+console_buffer_t console_buffers[PLATFORM_CORE_COUNT];
+static spinlock_t console_buffer_lock;
+#endif /* CONSOLE_BUFFERED */
+
 IMPORT_SYM(console_t *, __STACKS_START__, stacks_start)
 IMPORT_SYM(console_t *, __STACKS_END__, stacks_end)
 
@@ -62,6 +107,12 @@ int console_is_registered(console_t *to_find)
 
 void console_switch_state(unsigned int new_state)
 {
+	/* Characters buffered by this CPU belong to the previous state */
+	if ((console_state == CONSOLE_FLAG_RUNTIME) &&
+	    (new_state != CONSOLE_FLAG_RUNTIME)) {
+		console_drain();
+	}
+
 	console_state = new_state;
 }
 
@@ -86,7 +137,7 @@ static int do_putc(int c, console_t *console)
 	return console->putc(c, console);
 }
 
-int console_putc(int c)
+static int console_write(int c)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
@@ -100,6 +151,108 @@ int console_putc(int c)
 	return err;
 }
 
+#if CONSOLE_BUFFERED
+/* The buffers and their lock are cacheable memory, used once the MMU is on */
+static bool console_buffer_cached(void)
+{
+	return (read_sctlr_el3() & SCTLR_C_BIT) != 0U;
+}
+
+static bool console_buffer_usable(void)
+{
+	console_t *console;
+
+	if ((console_state != CONSOLE_FLAG_RUNTIME) ||
+	    !console_buffer_cached()) {
+		return false;
+	}
+
+	for (console = console_list; console != NULL; console = console->next) {
+		if (((console->flags & console_state) != 0U) &&
+		    (console->putc != NULL)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void console_buffer_drain(console_buffer_t *buf)
+{
+	unsigned int head;
+	unsigned int tail;
+
+	spin_lock(&console_buffer_lock);
+
+	/* Read the characters only once the owner has published them */
+	head = buf->head;
+	dmbish();
+
+	for (tail = buf->tail; tail != head; tail++) {
+		(void)console_write(
+			buf->data[tail & (PLAT_CONSOLE_BUFFER_SIZE - 1U)]);
+	}
+
+	/* Release the space only once the characters have been read */
+	dmbish();
+	buf->tail = tail;
+
+	spin_unlock(&console_buffer_lock);
+}
+
+/*
+ * This is called on the CPU_SUSPEND and CPU_OFF paths, which then wait for the
+ * UARTs to take up to PLAT_CONSOLE_BUFFER_SIZE characters, e.g. about 90ms for
+ * 1KB at 115200 bauds. The flushes at the end of a line when the buffer is
+ * half full and on errors and warnings keep this well under the buffer size
+ * in practice. Skipping the drain would instead leave the output of a CPU
+ * which is then turned off until the next console_flush().
+ */
+void console_drain(void)
+{
+	if (console_buffer_cached()) {
+		console_buffer_drain(&console_buffers[plat_my_core_pos()]);
+	}
+}
+
+static int console_buffer_putc(int c)
+{
+	console_buffer_t *buf = &console_buffers[plat_my_core_pos()];
+	unsigned int head = buf->head;
+
+	/* Make room by writing out what this CPU has buffered so far */
+	if ((head - buf->tail) == PLAT_CONSOLE_BUFFER_SIZE) {
+		console_buffer_drain(buf);
+	}
+
+	/* Do not overwrite characters before a drain has read them */
+	dmbish();
+	buf->data[head & (PLAT_CONSOLE_BUFFER_SIZE - 1U)] = (char)c;
+
+	/* Publish the character to the CPUs draining the buffer */
+	dmbish();
+	buf->head = head + 1U;
+
+	/* Do not leave lines buffered for long on a CPU which never idles */
+	if ((c == '\n') &&
+	    ((head + 1U - buf->tail) >= (PLAT_CONSOLE_BUFFER_SIZE / 2U))) {
+		console_buffer_drain(buf);
+	}
+
+	return c;
+}
+#endif /* CONSOLE_BUFFERED */
+
+int console_putc(int c)
+{
+#if CONSOLE_BUFFERED
+	if (console_buffer_usable()) {
+		return console_buffer_putc(c);
+	}
+#endif
+	return console_write(c);
+}
+
 int putchar(int c)
 {
 	if (console_putc(c) == 0)
@@ -131,6 +284,19 @@ int console_getc(void)
 void console_flush(void)
 {
 	console_t *console;
+#if CONSOLE_BUFFERED
+	unsigned int i;
+
+	/*
+	 * Write out the characters buffered by all CPUs. Nothing is buffered
+	 * before the data cache is enabled.
+	 */
+	if (console_buffer_cached()) {
+		for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+			console_buffer_drain(&console_buffers[i]);
+		}
+	}
+#endif
 
 	for (console = console_list; console != NULL; console = console->next)
 		if ((console->flags & console_state) && (console->flush != NULL)) {
@@ -171,6 +171,33 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
 	return 0;
 }
 
+/*
+ * Return the number of bytes that can be transferred directly between the
+ * caller's buffer and the device, bypassing the bounce buffer. This requires
+ * the device to allow it, the file position and the buffer address to be
+ * block aligned, and only whole blocks are transferred this way.
+ */
+static size_t block_direct_size(const block_dev_state_t *cur,
+				uintptr_t buffer, size_t left)
+{
+	size_t block_size = cur->dev_spec->block_size;
+	size_t max_xfer_size = cur->dev_spec->max_xfer_size;
+	size_t size;
+
+	if ((max_xfer_size == 0U) ||
+	    ((cur->file_pos & (block_size - 1U)) != 0U) ||
+	    ((buffer & (block_size - 1U)) != 0U)) {
+		return 0U;
+	}
+
+	size = left & ~(block_size - 1U);
+	if (size > max_xfer_size) {
+		size = max_xfer_size;
+	}
+
+	return size;
+}
+
 /*
  * This function allows the caller to read any number of bytes
  * from any position. It hides from the caller that the low level
@@ -240,6 +267,15 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * If the device sets max_xfer_size, whole blocks at a block-aligned
+ * position are read straight into the caller's buffer when it is block
+ * aligned too, so the underlying buffer is only used for the unaligned
+ * head and tail of the request. The head is then read on its own.
+ * This requires the position and the caller's buffer to have the same
+ * offset within a block, e.g. when a FIP is created with
+ * 'fiptool --align <block size>' and images are loaded at block-aligned
+ * addresses.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
@@ -296,6 +332,19 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+		/* Read aligned blocks without going through the buffer */
+		request = block_direct_size(cur, buffer + count, left);
+		if (request != 0U) {
+			nbytes = ops->read(lba, buffer + count, request);
+			if ((nbytes == 0U) || (nbytes > request)) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if ((skip + left) > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
@@ -314,6 +363,16 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			request = (request + (block_size - 1U)) &
 				~(block_size - 1U);
 		}
+
+		/*
+		 * Only bounce the partial head block when the following
+		 * blocks can then be read directly into the caller's buffer.
+		 */
+		if ((cur->dev_spec->max_xfer_size != 0U) && (skip != 0U) &&
+		    (request > block_size) &&
+		    (((buffer + count - skip) & (block_size - 1U)) == 0U)) {
+			request = block_size;
+		}
 		request = ops->read(lba, buf->offset, request);
 
 		if (request <= skip) {
@@ -350,7 +409,8 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 /*
  * This function allows the caller to write any number of bytes
  * from any position. It hides from the caller that the low level
- * driver only can write aligned blocks of data.
+ * driver only can write aligned blocks of data. Aligned blocks are
+ * written directly from the caller's buffer when the device allows it.
  * See comments for block_read for more details.
  */
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
@@ -409,6 +469,22 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+		/*
+		 * Whole aligned blocks need no read-modify-write, write
+		 * them straight from the user buffer
+		 */
+		request = block_direct_size(cur, buffer + count, left);
+		if (request != 0U) {
+			nbytes = ops->write(lba, buffer + count, request);
+			if ((nbytes == 0U) || (nbytes > request)) {
+				return -EIO;
+			}
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if ((skip + left) > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
@@ -518,7 +594,8 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 	assert((block_size > 0U) &&
 	       (is_power_of_2(block_size) != 0U) &&
 	       ((buffer->offset % block_size) == 0U) &&
-	       ((buffer->length % block_size) == 0U));
+	       ((buffer->length % block_size) == 0U) &&
+	       ((cur->dev_spec->max_xfer_size % block_size) == 0U));
 
 	*dev_info = info;	/* cast away const */
 	(void)block_size;
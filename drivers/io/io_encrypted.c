@@ -23,6 +23,12 @@
 #include <tools_share/firmware_encrypted.h>
 #include <tools_share/uuid.h>
 
+/*
+ * Size of the chunks in which the payload is read and decrypted, when the
+ * crypto library can decrypt incrementally
+ */
+#define ENC_READ_CHUNK_SIZE	U(0x4000)
+
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_dev_spec;
 static uintptr_t backend_handle;
@@ -150,6 +156,79 @@ static int enc_file_len(io_entity_t *entity, size_t *length)
 	return result;
 }
 
+/*
+ * Read the payload chunk by chunk and decrypt each chunk while it is still hot
+ * in the cache. Short reads from the backend are completed before decrypting,
+ * so that only the last chunk may be smaller than ENC_READ_CHUNK_SIZE. The
+ * decryption context holds its own copy of the key.
+ */
+static int enc_read_decrypt(uintptr_t buffer, size_t length,
+			    size_t *length_read,
+			    const struct fw_enc_hdr *header)
+{
+	size_t offset = 0U;
+	size_t decrypted = 0U;
+	size_t chunk_end;
+	size_t bytes_read;
+	int result = 0;
+	int rc = CRYPTO_SUCCESS;
+	int finish_rc;
+
+	while (offset < length) {
+		chunk_end = MIN(length, decrypted + ENC_READ_CHUNK_SIZE);
+
+		result = io_read(backend_handle, buffer + offset,
+				 chunk_end - offset, &bytes_read);
+		if ((result != 0) || (bytes_read == 0U)) {
+			break;
+		}
+
+		offset += bytes_read;
+		if (offset < chunk_end) {
+			continue;
+		}
+
+		rc = crypto_mod_auth_decrypt_update(
+				(void *)(buffer + decrypted),
+				offset - decrypted);
+		decrypted = offset;
+		if (rc != CRYPTO_SUCCESS) {
+			break;
+		}
+	}
+
+	/* Decrypt whatever is left of a payload shorter than expected */
+	if ((result == 0) && (rc == CRYPTO_SUCCESS) && (decrypted < offset)) {
+		rc = crypto_mod_auth_decrypt_update(
+				(void *)(buffer + decrypted),
+				offset - decrypted);
+	}
+
+	/* Always finish, to release the decryption context */
+	finish_rc = crypto_mod_auth_decrypt_finish(header->tag,
+						   header->tag_len);
+	if (rc == CRYPTO_SUCCESS) {
+		rc = finish_rc;
+	}
+
+	*length_read = offset;
+
+	if (result != 0) {
+		WARN("Failed to read encrypted payload (%i)\n", result);
+		result = -ENOENT;
+	} else if (rc != CRYPTO_SUCCESS) {
+		ERROR("File decryption failed (%i)\n", rc);
+		result = -ENOENT;
+	}
+
+	if (result != 0) {
+		/* Do not leave unauthenticated plaintext behind */
+		zeromem((void *)buffer, offset);
+	}
+
+	return result;
+}
+
 static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			 size_t *length_read)
 {
@@ -186,22 +265,35 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		return -ENOENT;
 	}
 
-	result = io_read(backend_handle, buffer, length, &bytes_read);
+	result = plat_get_enc_key_info(fw_enc_status, key, &key_len, &key_flags,
+				       (uint8_t *)&uuid_spec->uuid,
+				       sizeof(uuid_t));
 	if (result != 0) {
-		WARN("Failed to read encrypted payload (%i)\n", result);
+		WARN("Failed to obtain encryption key (%i)\n", result);
 		return -ENOENT;
 	}
 
-	*length_read = bytes_read;
+	result = crypto_mod_auth_decrypt_init(header.dec_algo, key, key_len,
+					      key_flags, header.iv,
+					      header.iv_len);
+	if (result == CRYPTO_SUCCESS) {
+		memset(key, 0, key_len);
+		return enc_read_decrypt(buffer, length, length_read, &header);
+	}
 
-	result = plat_get_enc_key_info(fw_enc_status, key, &key_len, &key_flags,
-				       (uint8_t *)&uuid_spec->uuid,
-				       sizeof(uuid_t));
+	/*
+	 * The crypto library cannot decrypt incrementally, read the whole
+	 * payload and decrypt it in one go.
+	 */
+	result = io_read(backend_handle, buffer, length, &bytes_read);
 	if (result != 0) {
-		WARN("Failed to obtain encryption key (%i)\n", result);
+		WARN("Failed to read encrypted payload (%i)\n", result);
+		memset(key, 0, key_len);
 		return -ENOENT;
 	}
 
+	*length_read = bytes_read;
+
 	result = crypto_mod_auth_decrypt(header.dec_algo,
 					 (void *)buffer, *length_read, key,
 					 key_len, key_flags, header.iv,
@@ -211,6 +303,7 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 
 	if (result != 0) {
 		ERROR("File decryption failed (%i)\n", result);
+		zeromem((void *)buffer, *length_read);
 		return -ENOENT;
 	}
 
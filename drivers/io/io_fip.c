@@ -1,11 +1,12 @@
 /*
- * Copyright (c) 2014-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -16,6 +17,7 @@
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_fip.h>
 #include <drivers/io/io_storage.h>
+#include <lib/cassert.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 #include <tools_share/firmware_image_package.h>
@@ -25,6 +27,25 @@
 #define MAX_FIP_DEVICES		1
 #endif
 
+/* Maximum number of ToC entries indexed per FIP device */
+#ifndef FIP_MAX_TOC_ENTRIES
+#define FIP_MAX_TOC_ENTRIES	32U
+#endif
+
+/* Maximum number of files open at the same time across all FIP devices */
+#ifndef FIP_MAX_FILES
+#define FIP_MAX_FILES		2U
+#endif
+
+/* Number of open-addressed hash slots used to look up ToC entries by UUID */
+#define FIP_TOC_HASH_SLOTS	(2U * FIP_MAX_TOC_ENTRIES)
+
+/* Number of ToC entries read from the backend in a single request */
+#define FIP_TOC_READ_BATCH	8U
+
+/* Hash slots store an index into the ToC plus one, zero marking a free slot */
+CASSERT(FIP_MAX_TOC_ENTRIES < UINT8_MAX, assert_fip_max_toc_entries);
+
 /* Useful for printing UUIDs when debugging.*/
 #define PRINT_UUID2(x)								\
 	"%08x-%04hx-%04hx-%02hhx%02hhx-%02hhx%02hhx%02hhx%02hhx%02hhx%02hhx",	\
@@ -33,32 +54,55 @@
 		x.node[0], x.node[1], x.node[2], x.node[3],			\
 		x.node[4], x.node[5]
 
+/* Compact copy of a ToC entry, as kept in the ToC index */
 typedef struct {
-	unsigned int file_pos;
-	fip_toc_entry_t entry;
-} fip_file_state_t;
+	uuid_t uuid;
+	uint64_t offset_address;
+	uint64_t size;
+} fip_toc_index_entry_t;
 
 /*
- * Maintain dev_spec per FIP Device
- * TODO - Add backend handles and file state
- * per FIP device here once backends like io_memmap
- * can support multiple open files
+ * Index of the ToC of a FIP, so that opening a file does not touch the
+ * backend until the payload is read. It is built by fip_dev_init() for the
+ * backend device and spec reported by the platform, and dropped when the
+ * FIP device is closed or initialised for another backend.
+ */
+typedef struct {
+	bool valid;
+	uintptr_t backend_dev_handle;
+	uintptr_t backend_image_spec;
+	/* The ToC has more entries than FIP_MAX_TOC_ENTRIES */
+	bool truncated;
+	unsigned int count;
+	fip_toc_index_entry_t entries[FIP_MAX_TOC_ENTRIES];
+	uint8_t hash[FIP_TOC_HASH_SLOTS];
+} fip_toc_index_t;
+
+/*
+ * Maintain dev_spec, backend and the ToC index in use per FIP Device.
  */
 typedef struct {
 	uintptr_t dev_spec;
 	uint16_t plat_toc_flag;
+	uintptr_t backend_dev_handle;
+	uintptr_t backend_image_spec;
+	fip_toc_index_t toc;
 } fip_dev_state_t;
 
 /*
- * Only one file can be open across all FIP device
- * as backends like io_memmap don't support
- * multiple open files. The file state and
- * backend handle should be maintained per FIP device
- * if the same support is available in the backend
+ * A file open in a FIP. The backend is opened for each read only, so
+ * several files can be open at the same time even when the backend, like
+ * io_memmap, supports a single open file.
  */
-static fip_file_state_t current_fip_file = {0};
-static uintptr_t backend_dev_handle;
-static uintptr_t backend_image_spec;
+typedef struct {
+	fip_dev_state_t *dev;
+	unsigned int file_pos;
+	fip_toc_index_entry_t entry;
+} fip_file_state_t;
+
+static fip_file_state_t file_pool[FIP_MAX_FILES];
+
+static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
 
 static fip_dev_state_t state_pool[MAX_FIP_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_FIP_DEVICES];
@@ -183,8 +227,8 @@ static int free_dev_info(io_dev_info_t *dev_info)
 
 /*
  * Multiple FIP devices can be opened depending on the value of
- * MAX_FIP_DEVICES. Given that there is only one backend, only a
- * single file can be open at a time by any FIP device.
+ * MAX_FIP_DEVICES. Up to FIP_MAX_FILES files can be open at a time
+ * across all FIP devices.
  */
 static int fip_dev_open(const uintptr_t dev_spec,
 			 io_dev_info_t **dev_info)
@@ -212,11 +256,210 @@ static int fip_dev_open(const uintptr_t dev_spec,
 }
 
 
-/* Do some basic package checks. */
+/* Hash a UUID into the ToC index (32-bit FNV-1a) */
+static unsigned int fip_uuid_hash(const uuid_t *uuid)
+{
+	const uint8_t *bytes = (const uint8_t *)uuid;
+	uint32_t hash = 0x811c9dc5U;
+	unsigned int i;
+
+	for (i = 0U; i < sizeof(uuid_t); i++) {
+		hash ^= bytes[i];
+		hash *= 0x01000193U;
+	}
+
+	return (unsigned int)(hash % FIP_TOC_HASH_SLOTS);
+}
+
+/* Find the indexed ToC entry for a UUID, NULL if it is not indexed */
+static const fip_toc_index_entry_t *fip_toc_lookup(
+				const fip_toc_index_t *toc,
+				const uuid_t *uuid)
+{
+	unsigned int slot = fip_uuid_hash(uuid);
+	unsigned int i;
+
+	for (i = 0U; i < FIP_TOC_HASH_SLOTS; i++) {
+		uint8_t index = toc->hash[slot];
+
+		if (index == 0U) {
+			break;
+		}
+
+		if (compare_uuids(&toc->entries[index - 1U].uuid, uuid) == 0) {
+			return &toc->entries[index - 1U];
+		}
+
+		slot = (slot + 1U) % FIP_TOC_HASH_SLOTS;
+	}
+
+	return NULL;
+}
+
+/*
+ * Add a ToC entry to the index. Return false if the index is full.
+ * Like the ToC walk it replaces, the first entry found for a UUID wins.
+ */
+static bool fip_toc_add(fip_toc_index_t *toc, const fip_toc_entry_t *entry)
+{
+	fip_toc_index_entry_t *index_entry;
+	unsigned int slot;
+
+	if (fip_toc_lookup(toc, &entry->uuid) != NULL) {
+		return true;
+	}
+
+	if (toc->count == FIP_MAX_TOC_ENTRIES) {
+		return false;
+	}
+
+	index_entry = &toc->entries[toc->count];
+	index_entry->uuid = entry->uuid;
+	index_entry->offset_address = entry->offset_address;
+	index_entry->size = entry->size;
+	toc->count++;
+
+	/* There are always free slots as there are more slots than entries */
+	slot = fip_uuid_hash(&entry->uuid);
+	while (toc->hash[slot] != 0U) {
+		slot = (slot + 1U) % FIP_TOC_HASH_SLOTS;
+	}
+	toc->hash[slot] = (uint8_t)toc->count;
+
+	return true;
+}
+
+/*
+ * Read the Table of Contents following the FIP header and index it. The
+ * backend file position must be just past the header. Entries are read in
+ * batches, bounded by the size of the backend file when it is known.
+ */
+static int fip_toc_parse(fip_toc_index_t *toc, uintptr_t backend_handle)
+{
+	fip_toc_entry_t batch[FIP_TOC_READ_BATCH];
+	size_t fip_size = 0U;
+	size_t pos = sizeof(fip_toc_header_t);
+	size_t bytes_read;
+	size_t length;
+	unsigned int i;
+	bool bounded;
+	int result;
+
+	toc->count = 0U;
+	toc->truncated = false;
+	zeromem(toc->hash, sizeof(toc->hash));
+
+	bounded = (io_size(backend_handle, &fip_size) == 0);
+
+	for (;;) {
+		length = sizeof(batch);
+		if (bounded) {
+			if (pos >= fip_size) {
+				break;
+			}
+			if ((fip_size - pos) < length) {
+				length = fip_size - pos;
+				length -= length % sizeof(fip_toc_entry_t);
+				if (length == 0U) {
+					break;
+				}
+			}
+		}
+
+		result = io_read(backend_handle, (uintptr_t)batch, length,
+				 &bytes_read);
+		if (result != 0) {
+			WARN("Failed to read FIP (%i)\n", result);
+			return result;
+		}
+
+		for (i = 0U; i < (bytes_read / sizeof(fip_toc_entry_t)); i++) {
+			if (compare_uuids(&batch[i].uuid, &uuid_null) == 0) {
+				return 0;
+			}
+
+			if (!fip_toc_add(toc, &batch[i])) {
+				VERBOSE("FIP ToC index full, %u entries\n",
+					toc->count);
+				toc->truncated = true;
+				return 0;
+			}
+		}
+
+		if (bytes_read < length) {
+			break;
+		}
+		pos += bytes_read;
+	}
+
+	return 0;
+}
+
+/*
+ * Walk the part of the ToC that did not fit in the index, looking for a
+ * UUID. This is only used when the ToC has more than FIP_MAX_TOC_ENTRIES
+ * entries.
+ */
+static int fip_toc_scan(const fip_dev_state_t *state, const uuid_t *uuid,
+			fip_toc_index_entry_t *entry_out)
+{
+	fip_toc_entry_t entry;
+	uintptr_t backend_handle;
+	size_t bytes_read;
+	size_t offset;
+	int result;
+
+	result = io_open(state->backend_dev_handle, state->backend_image_spec,
+			 &backend_handle);
+	if (result != 0) {
+		WARN("Failed to open Firmware Image Package (%i)\n", result);
+		return -ENOENT;
+	}
+
+	/* Seek past the FIP header and the indexed entries */
+	offset = sizeof(fip_toc_header_t) +
+		 (state->toc.count * sizeof(fip_toc_entry_t));
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 (signed long long)offset);
+	if (result != 0) {
+		WARN("fip_file_open: failed to seek\n");
+		result = -ENOENT;
+		goto fip_toc_scan_close;
+	}
+
+	result = -ENOENT;
+	do {
+		if (io_read(backend_handle, (uintptr_t)&entry, sizeof(entry),
+			    &bytes_read) != 0) {
+			WARN("Failed to read FIP\n");
+			break;
+		}
+		if (compare_uuids(&entry.uuid, uuid) == 0) {
+			entry_out->uuid = entry.uuid;
+			entry_out->offset_address = entry.offset_address;
+			entry_out->size = entry.size;
+			result = 0;
+		}
+	} while ((result != 0) &&
+		 (compare_uuids(&entry.uuid, &uuid_null) != 0));
+
+ fip_toc_scan_close:
+	io_close(backend_handle);
+
+	return result;
+}
+
+/*
+ * Do some basic package checks and index the ToC. The index is kept as
+ * long as the device stays open and the platform reports the same backend
+ * for the FIP, as this function may be called again for each image.
+ */
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 {
 	int result;
 	unsigned int image_id = (unsigned int)init_params;
+	uintptr_t backend_dev_handle;
+	uintptr_t backend_image_spec;
 	uintptr_t backend_handle;
 	fip_toc_header_t header;
 	size_t bytes_read;
@@ -236,6 +479,18 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 		goto fip_dev_init_exit;
 	}
 
+	state->backend_dev_handle = backend_dev_handle;
+	state->backend_image_spec = backend_image_spec;
+	if (state->toc.valid &&
+	    (state->toc.backend_dev_handle == backend_dev_handle) &&
+	    (state->toc.backend_image_spec == backend_image_spec)) {
+		return 0;
+	}
+
+	state->toc.valid = false;
+	state->toc.backend_dev_handle = backend_dev_handle;
+	state->toc.backend_image_spec = backend_image_spec;
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -258,6 +513,13 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 			 * bits [32-47] in fip header.
 			 */
 			state->plat_toc_flag = (header.flags >> 32) & 0xffff;
+
+			result = fip_toc_parse(&state->toc, backend_handle);
+			if (result == 0) {
+				state->toc.valid = true;
+			} else {
+				result = -ENOENT;
+			}
 		}
 	}
 
@@ -272,9 +534,8 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 {
 	/* TODO: Consider tracking open files and cleaning them up here */
 
-	/* Clear the backend. */
-	backend_dev_handle = (uintptr_t)NULL;
-	backend_image_spec = (uintptr_t)NULL;
+	/* The backend may change before the next init, drop the ToC index. */
+	((fip_dev_state_t *)dev_info->info)->toc.valid = false;
 
 	return free_dev_info(dev_info);
 }
@@ -285,80 +546,59 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			 io_entity_t *entity)
 {
 	int result;
-	uintptr_t backend_handle;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
-	static const uuid_t uuid_null = { {0} }; /* Double braces for clang */
-	size_t bytes_read;
-	int found_file = 0;
+	const fip_toc_index_entry_t *index_entry;
+	fip_dev_state_t *state;
+	fip_file_state_t *fp = NULL;
+	unsigned int i;
 
+	assert(dev_info != NULL);
 	assert(uuid_spec != NULL);
 	assert(entity != NULL);
 
-	/* Can only have one file open at a time for the moment. We need to
-	 * track state like file cursor position. We know the header lives at
-	 * offset zero, so this entry should never be zero for an active file.
-	 * When the system supports dynamic memory allocation we can allow more
-	 * than one open file at a time if needed.
-	 */
-	if (current_fip_file.entry.offset_address != 0U) {
-		WARN("fip_file_open : Only one open file at a time.\n");
-		return -ENFILE;
+	state = (fip_dev_state_t *)dev_info->info;
+	if (!state->toc.valid) {
+		WARN("fip_file_open: FIP not initialised\n");
+		return -ENOENT;
 	}
 
-	/* Attempt to access the FIP image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to open Firmware Image Package (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_open_exit;
+	/*
+	 * We need to track state like the file cursor position for each
+	 * open file, so the number of open files is bounded by the pool.
+	 */
+	for (i = 0U; i < FIP_MAX_FILES; i++) {
+		if (file_pool[i].dev == NULL) {
+			fp = &file_pool[i];
+			break;
+		}
 	}
 
-	/* Seek past the FIP header into the Table of Contents */
-	result = io_seek(backend_handle, IO_SEEK_SET,
-			 (signed long long)sizeof(fip_toc_header_t));
-	if (result != 0) {
-		WARN("fip_file_open: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_open_close;
+	if (fp == NULL) {
+		WARN("fip_file_open : Too many open files.\n");
+		return -ENFILE;
 	}
 
-	found_file = 0;
-	do {
-		result = io_read(backend_handle,
-				 (uintptr_t)&current_fip_file.entry,
-				 sizeof(current_fip_file.entry),
-				 &bytes_read);
-		if (result == 0) {
-			if (compare_uuids(&current_fip_file.entry.uuid,
-					  &uuid_spec->uuid) == 0) {
-				found_file = 1;
-			}
-		} else {
-			WARN("Failed to read FIP (%i)\n", result);
-			goto fip_file_open_close;
-		}
-	} while ((found_file == 0) &&
-			(compare_uuids(&current_fip_file.entry.uuid,
-				&uuid_null) != 0));
-
-	if (found_file == 1) {
-		/* All fine. Update entity info with file state and return. Set
-		 * the file position to 0. The 'current_fip_file.entry' holds
-		 * the base and size of the file.
-		 */
-		current_fip_file.file_pos = 0;
-		entity->info = (uintptr_t)&current_fip_file;
+	index_entry = fip_toc_lookup(&state->toc, &uuid_spec->uuid);
+	if (index_entry != NULL) {
+		fp->entry = *index_entry;
+		result = 0;
+	} else if (state->toc.truncated) {
+		result = fip_toc_scan(state, &uuid_spec->uuid, &fp->entry);
 	} else {
 		/* Did not find the file in the FIP. */
-		current_fip_file.entry.offset_address = 0;
 		result = -ENOENT;
 	}
 
- fip_file_open_close:
-	io_close(backend_handle);
+	if (result == 0) {
+		/* All fine. Update entity info with file state and return. Set
+		 * the file position to 0. 'fp->entry' holds the base and size
+		 * of the file.
+		 */
+		fp->dev = state;
+		fp->file_pos = 0;
+		entity->info = (uintptr_t)fp;
+	}
 
- fip_file_open_exit:
 	return result;
 }
 
@@ -389,17 +629,17 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
+	fp = (fip_file_state_t *)entity->info;
+
 	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
+	result = io_open(fp->dev->backend_dev_handle,
+			 fp->dev->backend_image_spec, &backend_handle);
 	if (result != 0) {
 		WARN("Failed to open FIP (%i)\n", result);
 		result = -ENOENT;
 		goto fip_file_read_exit;
 	}
 
-	fp = (fip_file_state_t *)entity->info;
-
 	/* Seek to the position in the FIP where the payload lives */
 	file_offset = fp->entry.offset_address + fp->file_pos;
 	result = io_seek(backend_handle, IO_SEEK_SET,
@@ -434,11 +674,9 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
-	 * If we had malloc() we would free() here.
-	 */
-	if (current_fip_file.entry.offset_address != 0U) {
-		zeromem(&current_fip_file, sizeof(current_fip_file));
+	/* Return the file state to the pool. */
+	if (entity->info != (uintptr_t)NULL) {
+		zeromem((void *)entity->info, sizeof(fip_file_state_t));
 	}
 
 	/* Clear the Entity info. */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -201,6 +201,16 @@ int io_dev_close(uintptr_t dev_handle)
 	return result;
 }
 
+/* Return the type of a device */
+io_type_t io_dev_get_type(uintptr_t dev_handle)
+{
+	assert(is_valid_dev(dev_handle));
+
+	const io_dev_info_t *dev = (io_dev_info_t *)dev_handle;
+
+	return dev->funcs->type();
+}
+
 
 /* Synchronous operations */
 
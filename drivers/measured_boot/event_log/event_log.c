@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -288,10 +288,16 @@ int event_log_measure_and_record(uintptr_t data_base, uint32_t data_size,
 	}
 	assert(metadata_ptr->id != EVLOG_INVALID_ID);
 
-	/* Measure the payload with algorithm selected by EventLog driver */
-	rc = event_log_measure(data_base, data_size, hash_data);
-	if (rc != 0) {
-		return rc;
+	/*
+	 * Measure the payload with algorithm selected by EventLog driver,
+	 * unless its hash was already calculated while it was authenticated.
+	 */
+	if (crypto_mod_digest_lookup(data_id, CRYPTO_MD_ID, (void *)data_base,
+				     data_size, hash_data) != 0) {
+		rc = event_log_measure(data_base, data_size, hash_data);
+		if (rc != 0) {
+			return rc;
+		}
 	}
 
 	event_log_record(hash_data, EV_POST_CODE, metadata_ptr);
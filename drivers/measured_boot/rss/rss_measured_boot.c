@@ -80,11 +80,17 @@ int rss_mboot_measure_and_record(struct rss_mboot_metadata *metadata_ptr,
 		return 0;
 	}
 
-	/* Calculate hash */
-	rc = crypto_mod_calc_hash(CRYPTO_MD_ID,
-				  (void *)data_base, data_size, hash_data);
-	if (rc != 0) {
-		return rc;
+	/*
+	 * Calculate hash, unless it was already calculated while the image
+	 * was authenticated.
+	 */
+	if (crypto_mod_digest_lookup(data_id, CRYPTO_MD_ID, (void *)data_base,
+				     data_size, hash_data) != 0) {
+		rc = crypto_mod_calc_hash(CRYPTO_MD_ID, (void *)data_base,
+					  data_size, hash_data);
+		if (rc != 0) {
+			return rc;
+		}
 	}
 
 	ret = rss_measured_boot_extend_measurement(
@@ -15,11 +15,28 @@
 
 #include <platform_def.h>
 
+/* Number of blocks whose state is kept in the bad block table cache */
+#ifndef PLATFORM_MTD_MAX_BBT_BLOCKS
+#define PLATFORM_MTD_MAX_BBT_BLOCKS	U(4096)
+#endif
+
+#define BBT_WORDS	((PLATFORM_MTD_MAX_BBT_BLOCKS + 31U) / 32U)
+
 /*
  * Define a single nand_device used by specific NAND frameworks.
  */
 static struct nand_device nand_dev;
 
+/*
+ * Bad block table cache of nand_dev, filled lazily: a block is only checked on
+ * the device the first time it is accessed. The blocks beyond
+ * PLATFORM_MTD_MAX_BBT_BLOCKS are checked on every access.
+ */
+static struct {
+	uint32_t checked[BBT_WORDS];
+	uint32_t bad[BBT_WORDS];
+} nand_bbt;
+
 #pragma weak plat_get_scratch_buffer
 void plat_get_scratch_buffer(void **buffer_addr, size_t *buf_size)
 {
@@ -32,6 +49,34 @@ void plat_get_scratch_buffer(void **buffer_addr, size_t *buf_size)
 	*buf_size = sizeof(scratch_buff);
 }
 
+static int nand_block_is_bad(unsigned int block)
+{
+	unsigned int word = block / 32U;
+	uint32_t mask = BIT_32(block % 32U);
+	int is_bad;
+
+	if (block >= PLATFORM_MTD_MAX_BBT_BLOCKS) {
+		return nand_dev.mtd_block_is_bad(block);
+	}
+
+	if ((nand_bbt.checked[word] & mask) != 0U) {
+		return ((nand_bbt.bad[word] & mask) != 0U) ? 1 : 0;
+	}
+
+	is_bad = nand_dev.mtd_block_is_bad(block);
+	if (is_bad < 0) {
+		/* Check the block again on next access */
+		return is_bad;
+	}
+
+	nand_bbt.checked[word] |= mask;
+	if (is_bad == 1) {
+		nand_bbt.bad[word] |= mask;
+	}
+
+	return is_bad;
+}
+
 int nand_read(unsigned int offset, uintptr_t buffer, size_t length,
 	      size_t *length_read)
 {
@@ -43,6 +88,7 @@ int nand_read(unsigned int offset, uintptr_t buffer, size_t length,
 	unsigned int start_offset = offset % nand_dev.page_size;
 	unsigned int page;
 	unsigned int bytes_read;
+	unsigned int count;
 	int is_bad;
 	int ret;
 	uint8_t *scratch_buff;
@@ -63,7 +109,7 @@ int nand_read(unsigned int offset, uintptr_t buffer, size_t length,
 	}
 
 	while (block <= end_block) {
-		is_bad = nand_dev.mtd_block_is_bad(block);
+		is_bad = nand_block_is_bad(block);
 		if (is_bad < 0) {
 			return is_bad;
 		}
@@ -102,6 +148,21 @@ int nand_read(unsigned int offset, uintptr_t buffer, size_t length,
 				       bytes_read);
 
 				start_offset = 0U;
+			} else if ((nand_dev.mtd_read_pages != NULL) &&
+				   ((page + 1U) < nb_pages) &&
+				   (length >= (2U * nand_dev.page_size))) {
+				/* Read all the full pages left in the block */
+				count = MIN((size_t)(nb_pages - page),
+					    length / nand_dev.page_size);
+				ret = nand_dev.mtd_read_pages(&nand_dev,
+						(block * nb_pages) + page,
+						count, buffer);
+				if (ret != 0) {
+					return ret;
+				}
+
+				bytes_read = count * nand_dev.page_size;
+				page += count - 1U;
 			} else {
 				ret = nand_dev.mtd_read_page(&nand_dev,
 						(block * nb_pages) + page,
@@ -152,7 +213,7 @@ int nand_seek_bb(uintptr_t base, unsigned int offset, size_t *extra_offset)
 			return -EIO;
 		}
 
-		is_bad = nand_dev.mtd_block_is_bad(block);
+		is_bad = nand_block_is_bad(block);
 		if (is_bad < 0) {
 			return is_bad;
 		}
@@ -172,5 +233,8 @@ int nand_seek_bb(uintptr_t base, unsigned int offset, size_t *extra_offset)
 
 struct nand_device *get_nand_device(void)
 {
+	/* The device is being initialized, forget what was known of it */
+	zeromem(&nand_bbt, sizeof(nand_bbt));
+
 	return &nand_dev;
 }
@@ -327,6 +327,10 @@ static int nand_read_param_page(void)
 				     page.bytes_per_page *
 				     page.num_blk_in_lun * page.num_lun;
 
+	if ((page.opt_cmd & ONFI_OPT_CMD_READ_CACHE) != 0U) {
+		rawnand_dev.flags |= RAW_NAND_HAS_CACHE_READ;
+	}
+
 	if (page.nb_ecc_bits != GENMASK_32(7, 0)) {
 		rawnand_dev.nand_dev->ecc.max_bit_corr = page.nb_ecc_bits;
 		rawnand_dev.nand_dev->ecc.size = SZ_512;
@@ -399,6 +403,49 @@ static int nand_mtd_read_page_raw(struct nand_device *nand, unsigned int page,
 				  rawnand_dev.nand_dev->page_size);
 }
 
+/*
+ * Read consecutive pages with the cache read commands: while a page is read
+ * from the cache register, the device already loads the next one from the
+ * array.
+ */
+static int nand_mtd_read_pages_raw(struct nand_device *nand,
+				   unsigned int page, unsigned int nb_pages,
+				   uintptr_t buffer)
+{
+	unsigned int page_size = rawnand_dev.nand_dev->page_size;
+	unsigned int i;
+	int ret;
+
+	/* Load the first page */
+	ret = nand_read_page_cmd(page, 0U, 0U, 0U);
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (i = 0U; i < nb_pages; i++) {
+		ret = nand_send_cmd(((i + 1U) < nb_pages) ?
+				    NAND_CMD_READ_CACHE_SEQ :
+				    NAND_CMD_READ_CACHE_END, NAND_TWB_MAX);
+		if (ret != 0) {
+			return ret;
+		}
+
+		ret = nand_send_wait(PSEC_TO_MSEC(NAND_TR_MAX), NAND_TRR_MIN);
+		if (ret != 0) {
+			return ret;
+		}
+
+		ret = nand_read_data((uint8_t *)buffer, page_size, false);
+		if (ret != 0) {
+			return ret;
+		}
+
+		buffer += page_size;
+	}
+
+	return 0;
+}
+
 void nand_raw_ctrl_init(const struct nand_ctrl_ops *ops)
 {
 	rawnand_dev.ops = ops;
@@ -413,7 +460,9 @@ int nand_raw_init(unsigned long long *size, unsigned int *erase_size)
 
 	rawnand_dev.nand_dev->mtd_block_is_bad = nand_mtd_block_is_bad;
 	rawnand_dev.nand_dev->mtd_read_page = nand_mtd_read_page_raw;
+	rawnand_dev.nand_dev->mtd_read_pages = NULL;
 	rawnand_dev.nand_dev->ecc.mode = NAND_ECC_NONE;
+	rawnand_dev.flags = 0U;
 
 	if ((rawnand_dev.ops->setup == NULL) ||
 	    (rawnand_dev.ops->exec == NULL)) {
@@ -439,5 +488,14 @@ int nand_raw_init(unsigned long long *size, unsigned int *erase_size)
 
 	rawnand_dev.ops->setup(rawnand_dev.nand_dev);
 
+	/*
+	 * Cache reads only replace raw page reads, not the page reads of a
+	 * controller computing the ECC.
+	 */
+	if (((rawnand_dev.flags & RAW_NAND_HAS_CACHE_READ) != 0U) &&
+	    (rawnand_dev.nand_dev->mtd_read_page == nand_mtd_read_page_raw)) {
+		rawnand_dev.nand_dev->mtd_read_pages = nand_mtd_read_pages_raw;
+	}
+
 	return 0;
 }
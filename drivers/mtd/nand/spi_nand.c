@@ -229,6 +229,79 @@ static int spi_nand_read_page(unsigned int page, unsigned int offset,
 	return 0;
 }
 
+static int spi_nand_send_cmd(uint8_t opcode)
+{
+	struct spi_mem_op op;
+
+	zeromem(&op, sizeof(struct spi_mem_op));
+	op.cmd.opcode = opcode;
+	op.cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+
+	return spi_mem_exec_op(&op);
+}
+
+/*
+ * Read consecutive pages with the sequential cache read commands: while a page
+ * is read from the cache, the device already loads the next one from the
+ * array.
+ */
+static int spi_nand_read_pages_seq(unsigned int page, unsigned int nb_pages,
+				   uint8_t *buffer)
+{
+	unsigned int page_size = spinand_dev.nand_dev->page_size;
+	unsigned int i;
+	uint8_t status;
+	int ret;
+
+	ret = spi_nand_ecc_enable(true);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = spi_nand_load_page(page);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = spi_nand_wait_ready(&status);
+	if (ret != 0) {
+		return ret;
+	}
+
+	for (i = 0U; i < nb_pages; i++) {
+		ret = spi_nand_send_cmd(((i + 1U) < nb_pages) ?
+					SPI_NAND_OP_READ_CACHE_SEQ :
+					SPI_NAND_OP_READ_CACHE_END);
+		if (ret != 0) {
+			return ret;
+		}
+
+		ret = spi_nand_wait_ready(&status);
+		if (ret != 0) {
+			return ret;
+		}
+
+		ret = spi_nand_read_from_cache(page + i, 0U, buffer, page_size);
+		if (ret != 0) {
+			return ret;
+		}
+
+		if ((status & SPI_NAND_STATUS_ECC_UNCOR) != 0U) {
+			if ((i + 1U) < nb_pages) {
+				/* Leave the sequential read mode */
+				(void)spi_nand_send_cmd(SPI_NAND_OP_READ_CACHE_END);
+				(void)spi_nand_wait_ready(&status);
+			}
+
+			return -EBADMSG;
+		}
+
+		buffer += page_size;
+	}
+
+	return 0;
+}
+
 static int spi_nand_mtd_block_is_bad(unsigned int block)
 {
 	unsigned int nbpages_per_block = spinand_dev.nand_dev->block_size /
@@ -259,6 +332,13 @@ static int spi_nand_mtd_read_page(struct nand_device *nand, unsigned int page,
 				  spinand_dev.nand_dev->page_size, true);
 }
 
+static int spi_nand_mtd_read_pages(struct nand_device *nand,
+				   unsigned int page, unsigned int nb_pages,
+				   uintptr_t buffer)
+{
+	return spi_nand_read_pages_seq(page, nb_pages, (uint8_t *)buffer);
+}
+
 int spi_nand_init(unsigned long long *size, unsigned int *erase_size)
 {
 	uint8_t id[SPI_NAND_MAX_ID_LEN];
@@ -271,6 +351,7 @@ int spi_nand_init(unsigned long long *size, unsigned int *erase_size)
 
 	spinand_dev.nand_dev->mtd_block_is_bad = spi_nand_mtd_block_is_bad;
 	spinand_dev.nand_dev->mtd_read_page = spi_nand_mtd_read_page;
+	spinand_dev.nand_dev->mtd_read_pages = NULL;
 	spinand_dev.nand_dev->nb_planes = 1;
 
 	spinand_dev.spi_read_cache_op.cmd.opcode = SPI_NAND_OP_READ_FROM_CACHE;
@@ -285,6 +366,10 @@ int spi_nand_init(unsigned long long *size, unsigned int *erase_size)
 		return -EINVAL;
 	}
 
+	if ((spinand_dev.flags & SPI_NAND_HAS_CACHE_READ_SEQ) != 0U) {
+		spinand_dev.nand_dev->mtd_read_pages = spi_nand_mtd_read_pages;
+	}
+
 	assert((spinand_dev.nand_dev->page_size != 0U) &&
 	       (spinand_dev.nand_dev->block_size != 0U) &&
 	       (spinand_dev.nand_dev->size != 0U));
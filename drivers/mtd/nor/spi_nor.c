@@ -27,7 +27,85 @@
 
 #define SPI_READY_TIMEOUT_US	40000U
 
+/* SFDP tables, see JESD216 */
+#define SFDP_SIGNATURE		0x50444653U	/* "SFDP" */
+#define SFDP_MAJOR_REV		1U
+#define SFDP_MAX_PARAM_HEADERS	16U
+#define SFDP_BFPT_ID		0xFF00U		/* Basic flash parameters */
+#define SFDP_4BAIT_ID		0xFF84U		/* 4-byte address opcodes */
+
+#define BFPT_DWORDS_MIN		9U
+#define BFPT_DWORDS_MAX		17U
+#define BFPT_DWORD(i)		((i) - 1U)
+
+#define BFPT_DW1_ADDR_BYTES_MASK	GENMASK(18, 17)
+#define BFPT_DW1_ADDR_BYTES_3_ONLY	0U
+#define BFPT_DW1_ADDR_BYTES_4_ONLY	BIT(18)
+#define BFPT_DW2_DENSITY_POW2		BIT(31)
+#define BFPT_DW15_QER_SHIFT		20
+#define BFPT_DW15_QER_MASK		GENMASK(22, 20)
+
+/* Quad enable requirements of BFPT DWORD 15 */
+#define BFPT_QER_NONE			0U
+#define BFPT_QER_SR2_BIT1_BUGGY		1U
+#define BFPT_QER_SR1_BIT6		2U
+#define BFPT_QER_SR2_BIT1_NO_RD		4U
+#define BFPT_QER_SR2_BIT1		5U
+#define BFPT_QER_UNKNOWN		0xFFU
+
+struct sfdp_header {
+	uint32_t signature;
+	uint8_t minor;
+	uint8_t major;
+	uint8_t nph;		/* Number of parameter headers - 1 */
+	uint8_t unused;
+};
+
+struct sfdp_param_header {
+	uint8_t id_lsb;
+	uint8_t minor;
+	uint8_t major;
+	uint8_t length;		/* In DWORDs */
+	uint8_t ptp[3];		/* Parameter table pointer */
+	uint8_t id_msb;
+};
+
+/*
+ * Fast read modes of the BFPT, fastest first. The wait states, mode clocks
+ * and opcode of a mode are the 16-bit field at settings_shift in BFPT DWORD
+ * settings_dw. A mode is supported if support_bit is set in BFPT DWORD 1 or,
+ * when support_bit is 0, if its opcode is not 0.
+ */
+struct sfdp_read_mode {
+	uint8_t addr_buswidth;
+	uint8_t data_buswidth;
+	uint32_t support_bit;
+	uint8_t settings_dw;
+	uint8_t settings_shift;
+	uint8_t opcode_4b;
+	uint32_t bit_4bait;
+};
+
+static const struct sfdp_read_mode sfdp_read_modes[] = {
+	{ 8U, 8U, 0U, BFPT_DWORD(17U), 16U, SPI_NOR_OP_READ_1_8_8_4B,
+	  BIT(21) },
+	{ 1U, 8U, 0U, BFPT_DWORD(17U), 0U, SPI_NOR_OP_READ_1_1_8_4B,
+	  BIT(20) },
+	{ 4U, 4U, BIT(21), BFPT_DWORD(3U), 0U, SPI_NOR_OP_READ_1_4_4_4B,
+	  BIT(5) },
+	{ 1U, 4U, BIT(22), BFPT_DWORD(3U), 16U, SPI_NOR_OP_READ_1_1_4_4B,
+	  BIT(4) },
+	{ 2U, 2U, BIT(20), BFPT_DWORD(4U), 16U, SPI_NOR_OP_READ_1_2_2_4B,
+	  BIT(3) },
+	{ 1U, 2U, BIT(16), BFPT_DWORD(4U), 0U, SPI_NOR_OP_READ_1_1_2_4B,
+	  BIT(2) },
+};
+
 static struct nor_device nor_dev;
+static bool sfdp_valid;
+static uint8_t sfdp_qer = BFPT_QER_UNKNOWN;
+/* Fastest SFDP read op which does not need the QE bit to be set */
+static struct spi_mem_op sfdp_read_op_no_quad;
 
 #pragma weak plat_get_nor_data
 int plat_get_nor_data(struct nor_device *device)
@@ -214,6 +292,27 @@ static int spi_nor_quad_enable(void)
 	return 0;
 }
 
+/*
+ * Set the QE bit 1 of the second status register on devices that cannot read
+ * it back (BFPT QER 1 and 4). The status registers are written together, as
+ * writing the first one alone clears the second, and the other bits of the
+ * second status register are written to 0.
+ */
+static int spi_nor_quad_enable_no_rd(void)
+{
+	uint8_t sr_cr[2];
+	int ret;
+
+	ret = spi_nor_read_sr(&sr_cr[0]);
+	if (ret != 0) {
+		return ret;
+	}
+
+	sr_cr[1] = CR_QUAD_EN_SPAN;
+
+	return spi_nor_write_sr_cr(sr_cr);
+}
+
 static int spi_nor_clean_bar(void)
 {
 	int ret;
@@ -322,6 +421,265 @@ int spi_nor_read(unsigned int offset, uintptr_t buffer, size_t length,
 	return 0;
 }
 
+static int spi_nor_read_sfdp(uint32_t addr, void *buf, size_t len)
+{
+	struct spi_mem_op op;
+
+	zeromem(&op, sizeof(struct spi_mem_op));
+	op.cmd.opcode = SPI_NOR_OP_READ_SFDP;
+	op.cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.addr.nbytes = 3U;
+	op.addr.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.addr.val = addr;
+	op.dummy.nbytes = 1U;
+	op.dummy.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.data.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op.data.dir = SPI_MEM_DATA_IN;
+	op.data.nbytes = len;
+	op.data.buf = buf;
+
+	return spi_mem_exec_op(&op);
+}
+
+static uint32_t sfdp_param_addr(const struct sfdp_param_header *header)
+{
+	return ((uint32_t)header->ptp[2] << 16) |
+	       ((uint32_t)header->ptp[1] << 8) | header->ptp[0];
+}
+
+static bool sfdp_qer_supported(uint8_t qer)
+{
+	switch (qer) {
+	case BFPT_QER_UNKNOWN:
+	case BFPT_QER_NONE:
+	case BFPT_QER_SR2_BIT1_BUGGY:
+	case BFPT_QER_SR1_BIT6:
+	case BFPT_QER_SR2_BIT1_NO_RD:
+	case BFPT_QER_SR2_BIT1:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * Build the read op of a BFPT fast read mode, return false if the device or
+ * the bus does not support it. The mode clocks are sent as dummy cycles.
+ */
+static bool spi_nor_sfdp_read_op(const struct sfdp_read_mode *mode,
+				 const uint32_t *bfpt, uint8_t qer,
+				 struct spi_mem_op *op)
+{
+	struct spi_mem_op mode_op;
+	uint32_t settings = bfpt[mode->settings_dw] >> mode->settings_shift;
+	unsigned int cycles = (settings & 0x1FU) + ((settings >> 5) & 0x7U);
+	uint8_t opcode = (uint8_t)(settings >> 8);
+
+	if (mode->support_bit != 0U) {
+		if ((bfpt[BFPT_DWORD(1U)] & mode->support_bit) == 0U) {
+			return false;
+		}
+	} else if (opcode == 0U) {
+		return false;
+	}
+
+	if (((cycles * mode->addr_buswidth) % 8U) != 0U) {
+		return false;
+	}
+
+	if ((mode->data_buswidth == SPI_MEM_BUSWIDTH_4_LINE) &&
+	    !sfdp_qer_supported(qer)) {
+		return false;
+	}
+
+	zeromem(&mode_op, sizeof(struct spi_mem_op));
+	mode_op.cmd.opcode = opcode;
+	mode_op.cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	mode_op.addr.nbytes = 3U;
+	mode_op.addr.buswidth = mode->addr_buswidth;
+	mode_op.dummy.nbytes = (cycles * mode->addr_buswidth) / 8U;
+	mode_op.dummy.buswidth = mode->addr_buswidth;
+	mode_op.data.buswidth = mode->data_buswidth;
+	mode_op.data.dir = SPI_MEM_DATA_IN;
+	mode_op.data.nbytes = 1U;
+
+	if (!spi_mem_supports_op(&mode_op)) {
+		return false;
+	}
+
+	*op = mode_op;
+
+	return true;
+}
+
+/*
+ * Select the fastest BFPT read mode that the bus supports, excluding the
+ * quad data modes if 'quad' is false. 4-byte addressing is used when the
+ * device is larger than a bank.
+ */
+static void spi_nor_sfdp_select_op(const uint32_t *bfpt, uint32_t fourbait,
+				   uint8_t qer, bool quad,
+				   struct spi_mem_op *op)
+{
+	uint32_t addr_bytes;
+	unsigned int i;
+
+	/* Fast read 1-1-1 with 8 dummy cycles is supported by all devices */
+	zeromem(op, sizeof(struct spi_mem_op));
+	op->cmd.opcode = SPI_NOR_OP_READ_FAST;
+	op->cmd.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op->addr.nbytes = 3U;
+	op->addr.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op->dummy.nbytes = 1U;
+	op->dummy.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op->data.buswidth = SPI_MEM_BUSWIDTH_1_LINE;
+	op->data.dir = SPI_MEM_DATA_IN;
+	op->data.nbytes = 1U;
+
+	for (i = 0U; i < ARRAY_SIZE(sfdp_read_modes); i++) {
+		if (!quad && (sfdp_read_modes[i].data_buswidth ==
+			      SPI_MEM_BUSWIDTH_4_LINE)) {
+			continue;
+		}
+
+		if (spi_nor_sfdp_read_op(&sfdp_read_modes[i], bfpt, qer, op)) {
+			break;
+		}
+	}
+
+	addr_bytes = bfpt[BFPT_DWORD(1U)] & BFPT_DW1_ADDR_BYTES_MASK;
+	if (addr_bytes == BFPT_DW1_ADDR_BYTES_4_ONLY) {
+		op->addr.nbytes = 4U;
+	} else if ((addr_bytes != BFPT_DW1_ADDR_BYTES_3_ONLY) &&
+		   (nor_dev.size > BANK_SIZE)) {
+		/* Use the 4-byte opcode of the mode rather than the bank */
+		uint32_t bit_4bait = BIT(1);
+		uint8_t opcode_4b = SPI_NOR_OP_READ_FAST_4B;
+
+		if (i < ARRAY_SIZE(sfdp_read_modes)) {
+			bit_4bait = sfdp_read_modes[i].bit_4bait;
+			opcode_4b = sfdp_read_modes[i].opcode_4b;
+		}
+
+		if ((fourbait & bit_4bait) != 0U) {
+			op->cmd.opcode = opcode_4b;
+			op->addr.nbytes = 4U;
+		}
+	}
+
+	op->data.nbytes = 0U;
+}
+
+/*
+ * Parse the SFDP tables of the device to select the fastest read mode that
+ * the bus supports. nor_dev is only updated if the tables are valid.
+ */
+static int spi_nor_sfdp_init(void)
+{
+	struct sfdp_header header;
+	struct sfdp_param_header param;
+	uint32_t bfpt[BFPT_DWORDS_MAX];
+	uint32_t bfpt_addr = 0U;
+	uint32_t bfpt_len = 0U;
+	uint32_t fourbait_addr = 0U;
+	uint32_t fourbait = 0U;
+	unsigned long long size;
+	uint8_t qer = BFPT_QER_UNKNOWN;
+	struct spi_mem_op op;
+	unsigned int i;
+	int ret;
+
+	ret = spi_nor_read_sfdp(0U, &header, sizeof(header));
+	if (ret != 0) {
+		return ret;
+	}
+
+	if ((header.signature != SFDP_SIGNATURE) ||
+	    (header.major != SFDP_MAJOR_REV)) {
+		return -ENOTSUP;
+	}
+
+	for (i = 0U; (i <= header.nph) && (i < SFDP_MAX_PARAM_HEADERS); i++) {
+		uint16_t id;
+
+		ret = spi_nor_read_sfdp((uint32_t)(sizeof(header) +
+						   (i * sizeof(param))),
+					&param, sizeof(param));
+		if (ret != 0) {
+			return ret;
+		}
+
+		id = ((uint16_t)param.id_msb << 8) | param.id_lsb;
+
+		if ((id == SFDP_BFPT_ID) && (param.major == SFDP_MAJOR_REV) &&
+		    (param.length > bfpt_len)) {
+			/* Later revisions of the BFPT are longer */
+			bfpt_addr = sfdp_param_addr(&param);
+			bfpt_len = param.length;
+		} else if ((id == SFDP_4BAIT_ID) && (param.length != 0U)) {
+			fourbait_addr = sfdp_param_addr(&param);
+		}
+	}
+
+	if (bfpt_len < BFPT_DWORDS_MIN) {
+		return -ENOTSUP;
+	}
+
+	zeromem(bfpt, sizeof(bfpt));
+	ret = spi_nor_read_sfdp(bfpt_addr, bfpt,
+				MIN(bfpt_len, BFPT_DWORDS_MAX) *
+				sizeof(uint32_t));
+	if (ret != 0) {
+		return ret;
+	}
+
+	if ((bfpt[BFPT_DWORD(2U)] & BFPT_DW2_DENSITY_POW2) != 0U) {
+		uint32_t shift = bfpt[BFPT_DWORD(2U)] & ~BFPT_DW2_DENSITY_POW2;
+
+		if ((shift < 3U) || (shift > 35U)) {
+			return -ENOTSUP;
+		}
+
+		size = 1ULL << (shift - 3U);
+	} else {
+		size = ((unsigned long long)bfpt[BFPT_DWORD(2U)] + 1ULL) / 8U;
+	}
+
+	if ((size == 0ULL) || (size > UINT32_MAX)) {
+		return -ENOTSUP;
+	}
+
+	if (bfpt_len >= 15U) {
+		qer = (bfpt[BFPT_DWORD(15U)] & BFPT_DW15_QER_MASK) >>
+		      BFPT_DW15_QER_SHIFT;
+	}
+
+	if (fourbait_addr != 0U) {
+		ret = spi_nor_read_sfdp(fourbait_addr, &fourbait,
+					sizeof(fourbait));
+		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	if (nor_dev.size == 0U) {
+		nor_dev.size = (uint32_t)size;
+	}
+
+	spi_nor_sfdp_select_op(bfpt, fourbait, qer, true, &op);
+	spi_nor_sfdp_select_op(bfpt, fourbait, qer, false,
+			       &sfdp_read_op_no_quad);
+	nor_dev.read_op = op;
+	sfdp_qer = qer;
+	sfdp_valid = true;
+
+	VERBOSE("SFDP: opcode 0x%x, %u-%u-%u, %u address bytes\n",
+		op.cmd.opcode, op.cmd.buswidth, op.addr.buswidth,
+		op.data.buswidth, op.addr.nbytes);
+
+	return 0;
+}
+
 int spi_nor_init(unsigned long long *size, unsigned int *erase_size)
 {
 	int ret;
@@ -339,12 +697,15 @@ int spi_nor_init(unsigned long long *size, unsigned int *erase_size)
 		return -EINVAL;
 	}
 
-	assert(nor_dev.size != 0U);
-
-	if (nor_dev.size > BANK_SIZE) {
-		nor_dev.flags |= SPI_NOR_USE_BANK;
+	if ((nor_dev.flags & SPI_NOR_NO_SFDP) == 0U) {
+		ret = spi_nor_sfdp_init();
+		if (ret != 0) {
+			VERBOSE("No usable SFDP tables (%d)\n", ret);
+		}
 	}
 
+	assert(nor_dev.size != 0U);
+
 	*size = nor_dev.size;
 
 	ret = spi_nor_read_id(&id);
@@ -352,20 +713,24 @@ int spi_nor_init(unsigned long long *size, unsigned int *erase_size)
 		return ret;
 	}
 
-	if ((nor_dev.flags & SPI_NOR_USE_BANK) != 0U) {
-		switch (id) {
-		case SPANSION_ID:
-			nor_dev.bank_read_cmd = SPINOR_OP_BRRD;
-			nor_dev.bank_write_cmd = SPINOR_OP_BRWR;
+	if ((nor_dev.read_op.data.buswidth == 4U) &&
+	    (sfdp_qer != BFPT_QER_UNKNOWN)) {
+		switch (sfdp_qer) {
+		case BFPT_QER_NONE:
+			break;
+		case BFPT_QER_SR1_BIT6:
+			ret = spi_nor_macronix_quad_enable();
+			break;
+		case BFPT_QER_SR2_BIT1_BUGGY:
+		case BFPT_QER_SR2_BIT1_NO_RD:
+			ret = spi_nor_quad_enable_no_rd();
 			break;
 		default:
-			nor_dev.bank_read_cmd = SPINOR_OP_RDEAR;
-			nor_dev.bank_write_cmd = SPINOR_OP_WREAR;
+			/* The QE bit is bit 1 of the second status register */
+			ret = spi_nor_quad_enable();
 			break;
 		}
-	}
-
-	if (nor_dev.read_op.data.buswidth == 4U) {
+	} else if (nor_dev.read_op.data.buswidth == 4U) {
 		switch (id) {
 		case MACRONIX_ID:
 			INFO("Enable Macronix quad support\n");
@@ -379,6 +744,31 @@ int spi_nor_init(unsigned long long *size, unsigned int *erase_size)
 		}
 	}
 
+	if ((ret != 0) && sfdp_valid) {
+		/* The read mode comes from SFDP, use a mode without quad */
+		WARN("Quad enable failed (%d), using opcode 0x%x\n", ret,
+		     sfdp_read_op_no_quad.cmd.opcode);
+		nor_dev.read_op = sfdp_read_op_no_quad;
+		ret = 0;
+	}
+
+	if ((nor_dev.size > BANK_SIZE) && (nor_dev.read_op.addr.nbytes == 3U)) {
+		nor_dev.flags |= SPI_NOR_USE_BANK;
+	}
+
+	if ((nor_dev.flags & SPI_NOR_USE_BANK) != 0U) {
+		switch (id) {
+		case SPANSION_ID:
+			nor_dev.bank_read_cmd = SPINOR_OP_BRRD;
+			nor_dev.bank_write_cmd = SPINOR_OP_BRWR;
+			break;
+		default:
+			nor_dev.bank_read_cmd = SPINOR_OP_RDEAR;
+			nor_dev.bank_write_cmd = SPINOR_OP_WREAR;
+			break;
+		}
+	}
+
 	if ((ret == 0) && ((nor_dev.flags & SPI_NOR_USE_BANK) != 0U)) {
 		ret = spi_nor_read_bar();
 	}
@@ -38,17 +38,26 @@ static bool spi_mem_check_buswidth_req(uint8_t buswidth, bool tx)
 		return true;
 
 	case 2U:
-		if ((tx && (spi_slave.mode & (SPI_TX_DUAL | SPI_TX_QUAD)) !=
+		if ((tx && (spi_slave.mode & (SPI_TX_DUAL | SPI_TX_QUAD |
+					      SPI_TX_OCTAL)) != 0U) ||
+		    (!tx && (spi_slave.mode & (SPI_RX_DUAL | SPI_RX_QUAD |
+					       SPI_RX_OCTAL)) != 0U)) {
+			return true;
+		}
+		break;
+
+	case 4U:
+		if ((tx && (spi_slave.mode & (SPI_TX_QUAD | SPI_TX_OCTAL)) !=
 		     0U) ||
-		    (!tx && (spi_slave.mode & (SPI_RX_DUAL | SPI_RX_QUAD)) !=
+		    (!tx && (spi_slave.mode & (SPI_RX_QUAD | SPI_RX_OCTAL)) !=
 		     0U)) {
 			return true;
 		}
 		break;
 
-	case 4U:
-		if ((tx && (spi_slave.mode & SPI_TX_QUAD) != 0U) ||
-		    (!tx && (spi_slave.mode & SPI_RX_QUAD) != 0U)) {
+	case 8U:
+		if ((tx && (spi_slave.mode & SPI_TX_OCTAL) != 0U) ||
+		    (!tx && (spi_slave.mode & SPI_RX_OCTAL) != 0U)) {
 			return true;
 		}
 		break;
@@ -60,7 +69,17 @@ static bool spi_mem_check_buswidth_req(uint8_t buswidth, bool tx)
 	return false;
 }
 
-static bool spi_mem_supports_op(const struct spi_mem_op *op)
+/*
+ * spi_mem_supports_op() - Check if a memory operation is supported.
+ * @op: The memory operation to check.
+ *
+ * This function checks that the bus widths of @op are allowed by the mode of
+ * the SPI slave, so that memory drivers can select the fastest operation the
+ * bus can execute.
+ *
+ * Return: true if @op is supported, false otherwise.
+ */
+bool spi_mem_supports_op(const struct spi_mem_op *op)
 {
 	if (!spi_mem_check_buswidth_req(op->cmd.buswidth, true)) {
 		return false;
@@ -244,7 +263,7 @@ int spi_mem_init_slave(void *fdt, int bus_node, const struct spi_bus_ops *ops)
 			mode |= SPI_PREAMBLE;
 		}
 
-		/* Get dual/quad mode */
+		/* Get dual/quad/octal mode */
 		cuint = fdt_getprop(fdt, bus_subnode, "spi-tx-bus-width", NULL);
 		if (cuint != NULL) {
 			switch (fdt32_to_cpu(*cuint)) {
@@ -256,6 +275,9 @@ int spi_mem_init_slave(void *fdt, int bus_node, const struct spi_bus_ops *ops)
 			case 4U:
 				mode |= SPI_TX_QUAD;
 				break;
+			case 8U:
+				mode |= SPI_TX_OCTAL;
+				break;
 			default:
 				WARN("spi-tx-bus-width %u not supported\n",
 				     fdt32_to_cpu(*cuint));
@@ -274,6 +296,9 @@ int spi_mem_init_slave(void *fdt, int bus_node, const struct spi_bus_ops *ops)
 			case 4U:
 				mode |= SPI_RX_QUAD;
 				break;
+			case 8U:
+				mode |= SPI_RX_OCTAL;
+				break;
 			default:
 				WARN("spi-rx-bus-width %u not supported\n",
 				     fdt32_to_cpu(*cuint));
@@ -403,7 +403,7 @@ static int stm32_qspi_set_mode(unsigned int mode)
 		return ret;
 	}
 
-	if ((mode & SPI_CS_HIGH) != 0U) {
+	if ((mode & (SPI_CS_HIGH | SPI_TX_OCTAL | SPI_RX_OCTAL)) != 0U) {
 		return -ENODEV;
 	}
 
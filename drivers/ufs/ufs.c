@@ -16,6 +16,7 @@
 #include <common/debug.h>
 #include <drivers/delay_timer.h>
 #include <drivers/ufs.h>
+#include <lib/cassert.h>
 #include <lib/mmio.h>
 
 #define CDB_ADDR_MASK			127
@@ -27,8 +28,53 @@
 
 #define MAX_PRDT_SIZE			0x40000		/* 256KB */
 
+/*
+ * When reads are queued, the UTRL is at the start of the descriptor area,
+ * followed by a UTP command descriptor for each queue entry, and the UTMRL
+ * used to abort the requests is at the end of the area. Queue entry n uses
+ * slot n * UTRD_SLOT_STRIDE, so that the UTRDs of the requests in flight never
+ * share a cache line. Otherwise, the command descriptor of slot 0 follows its
+ * UTRD and its PRDT may grow up to the end of the area.
+ */
+#define UTRD_SLOT_STRIDE		((unsigned int)(CACHE_WRITEBACK_GRANULE \
+						/ sizeof(utrd_header_t)))
+#define UFS_QUEUE_DEPTH(slots)		(((slots) > UTRD_SLOT_STRIDE) ? \
+					 ((slots) / UTRD_SLOT_STRIDE) : 1U)
+#define MAX_UFS_QUEUE_DEPTH		(CAP_NUTRS_MASK + 1)
+#define UFS_UCD_SIZE			(UFS_DESC_SIZE - \
+					 ALIGN_CDB(sizeof(utrd_header_t)))
+
+/* Size of each of the READ(10) commands queued by ufs_read_blocks() */
+#define UFS_QUEUED_READ_SIZE		0x80000		/* 512KB */
+
+/* UTP task management request descriptor, with request and response UPIUs */
+#define UTMRD_SIZE			(sizeof(utp_utmrd_t) + \
+					 sizeof(tm_req_upiu_t) + \
+					 sizeof(tm_resp_upiu_t))
+#define UTMRL_ALIGN			0x400
+/* Task tag of task management requests, not used by transfer requests */
+#define UFS_TM_TASK_TAG			(MAX_UFS_QUEUE_DEPTH + 1)
+
+CASSERT(UTRD_SLOT_STRIDE != 0U, assert_ufs_utrd_slot_stride);
+CASSERT((ALIGN_8(sizeof(cmd_upiu_t)) + ALIGN_8(sizeof(resp_upiu_t)) +
+	 (UFS_QUEUED_READ_SIZE / MAX_PRDT_SIZE) * sizeof(prdt_t)) <=
+	UFS_UCD_SIZE, assert_ufs_queued_read_prdt_fits);
+CASSERT(sizeof(tm_req_upiu_t) == 32U, assert_ufs_tm_req_upiu_size);
+CASSERT(sizeof(tm_resp_upiu_t) == 32U, assert_ufs_tm_resp_upiu_size);
+
 static ufs_params_t ufs_params;
 static int nutrs;	/* Number of UTP Transfer Request Slots */
+static unsigned int queue_depth;	/* Maximum number of requests in flight */
+static uintptr_t ucd_base;	/* UTP command descriptor of queue entry 0 */
+static uintptr_t ucd_limit;	/* End of the PRDT of queue entry 0 */
+static uintptr_t utmrl_base;	/* UTMRL, only used when reads are queued */
+
+/* Reads queued by ufs_read_queued(), one per queue entry */
+static struct {
+	utp_utrd_t	utrd;
+	uintptr_t	buf;
+	size_t		length;
+} ufs_queue[MAX_UFS_QUEUE_DEPTH];
 
 /*
  * ufs_uic_error_handler - UIC error interrupts handler
@@ -373,39 +419,52 @@ static int ufshc_link_startup(uintptr_t base)
 	return -EIO;
 }
 
-/* Read Door Bell register to check if slot zero is available */
-static int is_slot_available(void)
+/* Read Door Bell register to check if a slot is available */
+static int is_slot_available(unsigned int slot)
 {
-	if (mmio_read_32(ufs_params.reg_base + UTRLDBR) & 0x1) {
+	if (mmio_read_32(ufs_params.reg_base + UTRLDBR) & (1U << slot)) {
 		return -EBUSY;
 	}
 	return 0;
 }
 
-static void get_utrd(utp_utrd_t *utrd)
+/*
+ * Prepare the UTRD of a queue entry. Single requests always use entry 0, whose
+ * PRDT may grow up to the end of the descriptor area.
+ */
+static void get_utrd(utp_utrd_t *utrd, unsigned int entry)
 {
 	uintptr_t base;
+	unsigned int slot;
 	int result;
 	utrd_header_t *hd;
 
 	assert(utrd != NULL);
-	result = is_slot_available();
+	assert(entry < queue_depth);
+	slot = entry * UTRD_SLOT_STRIDE;
+	result = is_slot_available(slot);
 	assert(result == 0);
 
 	/* clear utrd */
 	memset((void *)utrd, 0, sizeof(utp_utrd_t));
-	base = ufs_params.desc_base;
-	/* clear the descriptor */
-	memset((void *)base, 0, UFS_DESC_SIZE);
+	utrd->header = ufs_params.desc_base + slot * sizeof(utrd_header_t);
+	memset((void *)utrd->header, 0, sizeof(utrd_header_t));
+	/* clear the command descriptor */
+	base = ucd_base + entry * UFS_UCD_SIZE;
+	memset((void *)base, 0, UFS_UCD_SIZE);
 
-	utrd->header = base;
-	utrd->task_tag = 1; /* We always use the first slot */
+	utrd->task_tag = slot + 1;
 	/* CDB address should be aligned with 128 bytes */
-	utrd->upiu = ALIGN_CDB(utrd->header + sizeof(utrd_header_t));
+	utrd->upiu = base;
 	utrd->resp_upiu = ALIGN_8(utrd->upiu + sizeof(cmd_upiu_t));
 	utrd->size_upiu = utrd->resp_upiu - utrd->upiu;
 	utrd->size_resp_upiu = ALIGN_8(sizeof(resp_upiu_t));
 	utrd->prdt = utrd->resp_upiu + utrd->size_resp_upiu;
+	if (entry == 0U) {
+		utrd->prdt_limit = ucd_limit;
+	} else {
+		utrd->prdt_limit = base + UFS_UCD_SIZE;
+	}
 
 	hd = (utrd_header_t *)utrd->header;
 	hd->ucdba = utrd->upiu & UINT32_MAX;
@@ -416,6 +475,13 @@ static void get_utrd(utp_utrd_t *utrd)
 	(void)result;
 }
 
+/* Clean the UTRD and the first 'ucd_size' bytes of its command descriptor */
+static void flush_utrd(utp_utrd_t *utrd, size_t ucd_size)
+{
+	flush_dcache_range(utrd->header, sizeof(utrd_header_t));
+	flush_dcache_range(utrd->upiu, ucd_size);
+}
+
 /*
  * Prepare UTRD, Command UPIU, Response UPIU.
  */
@@ -427,7 +493,6 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	prdt_t *prdt;
 	unsigned int ulba;
 	unsigned int lba_cnt;
-	uintptr_t desc_limit;
 	uintptr_t prdt_end;
 
 	hd = (utrd_header_t *)utrd->header;
@@ -494,9 +559,8 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 		assert(lba_cnt <= UINT16_MAX);
 		prdt = (prdt_t *)utrd->prdt;
 
-		desc_limit = ufs_params.desc_base + ufs_params.desc_size;
 		while (length > 0) {
-			if ((uintptr_t)prdt + sizeof(prdt_t) > desc_limit) {
+			if ((uintptr_t)prdt + sizeof(prdt_t) > utrd->prdt_limit) {
 				ERROR("UFS: Exceeded descriptor limit. Image is too large\n");
 				panic();
 			}
@@ -519,7 +583,7 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	}
 
 	prdt_end = utrd->prdt + utrd->prdt_length * sizeof(prdt_t);
-	flush_dcache_range(utrd->header, prdt_end - utrd->header);
+	flush_utrd(utrd, prdt_end - utrd->upiu);
 	return 0;
 }
 
@@ -572,7 +636,7 @@ static int ufs_prepare_query(utp_utrd_t *utrd, uint8_t op, uint8_t idn,
 		assert(0);
 		break;
 	}
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_utrd(utrd, UFS_UCD_SIZE);
 	return 0;
 }
 
@@ -590,7 +654,7 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 
 	nop_out->trans_type = 0;
 	nop_out->task_tag = utrd->task_tag;
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_utrd(utrd, UFS_UCD_SIZE);
 }
 
 static void ufs_send_request(int task_tag)
@@ -609,25 +673,31 @@ static void ufs_send_request(int task_tag)
 	       UTRIACR_IATOVAL(0xFF);
 	mmio_write_32(ufs_params.reg_base + UTRIACR, data);
 	/* send request */
-	mmio_setbits_32(ufs_params.reg_base + UTRLDBR, 1 << slot);
+	mmio_write_32(ufs_params.reg_base + UTRLDBR, 1U << slot);
 }
 
-static int ufs_check_resp(utp_utrd_t *utrd, int trans_type, unsigned int timeout_ms)
+/*
+ * Send a request while others may be in flight. Writing 0 to a bit of the
+ * Door Bell register has no effect, whereas a read-modify-write could issue a
+ * request again if it completed in between.
+ */
+static void ufs_queue_request(int task_tag)
+{
+	mmio_write_32(ufs_params.reg_base + UTRLDBR, 1U << (task_tag - 1));
+}
+
+/* Check the response of a completed request */
+static int ufs_check_utrd(utp_utrd_t *utrd, int trans_type)
 {
 	utrd_header_t *hd;
 	resp_upiu_t *resp;
 	sense_data_t *sense;
 	unsigned int data;
-	int slot, result;
+	int slot;
 
 	hd = (utrd_header_t *)utrd->header;
 	resp = (resp_upiu_t *)utrd->resp_upiu;
 
-	result = ufs_wait_for_int_status(UFS_INT_UTRCS, timeout_ms, false);
-	if (result != 0) {
-		return result;
-	}
-
 	slot = utrd->task_tag - 1;
 
 	data = mmio_read_32(ufs_params.reg_base + UTRLDBR);
@@ -637,9 +707,14 @@ static int ufs_check_resp(utp_utrd_t *utrd, int trans_type, unsigned int timeout
 	 * completed to avoid cpu referring to the prefetched
 	 * data brought in before DMA completion.
 	 */
-	inv_dcache_range((uintptr_t)hd, UFS_DESC_SIZE);
-	assert(hd->ocs == OCS_SUCCESS);
-	assert((resp->trans_type & TRANS_TYPE_CODE_MASK) == trans_type);
+	inv_dcache_range((uintptr_t)hd, sizeof(utrd_header_t));
+	inv_dcache_range(utrd->upiu, UFS_UCD_SIZE);
+	if ((hd->ocs != OCS_SUCCESS) ||
+	    ((resp->trans_type & TRANS_TYPE_CODE_MASK) != trans_type)) {
+		WARN("UFS: Request %d failed (ocs 0x%x, type 0x%x)\n",
+		     utrd->task_tag, hd->ocs, resp->trans_type);
+		return -EIO;
+	}
 
 	sense = &resp->sd.sense;
 	if (sense->resp_code == SENSE_DATA_VALID &&
@@ -649,19 +724,149 @@ static int ufs_check_resp(utp_utrd_t *utrd, int trans_type, unsigned int timeout
 		return -EAGAIN;
 	}
 
-	(void)resp;
 	(void)slot;
 	(void)data;
 	return 0;
 }
 
-static void ufs_send_cmd(utp_utrd_t *utrd, uint8_t cmd_op, uint8_t lun, int lba, uintptr_t buf,
-			 size_t length)
+static int ufs_check_resp(utp_utrd_t *utrd, int trans_type, unsigned int timeout_ms)
+{
+	int result;
+
+	result = ufs_wait_for_int_status(UFS_INT_UTRCS, timeout_ms, false);
+	if (result != 0) {
+		return result;
+	}
+
+	return ufs_check_utrd(utrd, trans_type);
+}
+
+/*
+ * ufs_wait_for_slots - wait for any of the requests in flight to complete
+ * @slots: mask of the slots of the requests in flight
+ * @done: set to the mask of the slots whose request completed
+ *
+ * Returns
+ * 0 - at least one request completed
+ * -EIO - fatal error, needs re-init
+ * -EAGAIN - non-fatal error, caller can retry
+ * -ETIMEDOUT - timed out waiting for a request to complete
+ */
+static int ufs_wait_for_slots(uint32_t slots, uint32_t *done)
+{
+	uint64_t timeout = timeout_init_us(CMD_TIMEOUT_MS * 1000U);
+	uint32_t interrupt_status, pending;
+	int result;
+
+	do {
+		interrupt_status = mmio_read_32(ufs_params.reg_base + IS) &
+				   mmio_read_32(ufs_params.reg_base + IE);
+		if (interrupt_status & UFS_INT_ERR) {
+			mmio_write_32(ufs_params.reg_base + IS, interrupt_status & UFS_INT_ERR);
+			result = ufs_error_handler(interrupt_status, false);
+			if (result != 0) {
+				return result;
+			}
+		}
+
+		pending = mmio_read_32(ufs_params.reg_base + UTRLDBR) & slots;
+		if (pending != slots) {
+			mmio_write_32(ufs_params.reg_base + IS, UFS_INT_UTRCS);
+			*done = slots & ~pending;
+			return 0;
+		}
+	} while (!timeout_elapsed(timeout));
+
+	return -ETIMEDOUT;
+}
+
+/*
+ * Abort the request of a slot in the device with an ABORT TASK task management
+ * function, so that it does not carry on once the slot is cleared.
+ */
+static int ufs_abort_task(uint8_t lun, unsigned int slot)
+{
+	utp_utmrd_t *hd = (utp_utmrd_t *)utmrl_base;
+	tm_req_upiu_t *req;
+	tm_resp_upiu_t *resp;
+	uint64_t timeout;
+	uint32_t service;
+
+	req = (tm_req_upiu_t *)(utmrl_base + sizeof(utp_utmrd_t));
+	resp = (tm_resp_upiu_t *)((uintptr_t)req + sizeof(tm_req_upiu_t));
+
+	memset((void *)utmrl_base, 0, UTMRD_SIZE);
+	hd->ocs = OCS_MASK;
+	req->trans_type = TASK_MAN_REQ_UPIU;
+	req->lun = lun;
+	req->task_tag = UFS_TM_TASK_TAG;
+	req->tm_function = TM_FUNC_ABORT_TASK;
+	req->input_param1 = htobe32(lun);
+	req->input_param2 = htobe32(slot + 1U);
+	flush_dcache_range(utmrl_base, UTMRD_SIZE);
+
+	mmio_write_32(ufs_params.reg_base + UTMRLRSR, 1);
+	mmio_write_32(ufs_params.reg_base + UTMRLDBR, 1);
+
+	timeout = timeout_init_us(CMD_TIMEOUT_MS * 1000U);
+	while ((mmio_read_32(ufs_params.reg_base + UTMRLDBR) & 1U) != 0U) {
+		if (timeout_elapsed(timeout)) {
+			mmio_write_32(ufs_params.reg_base + UTMRLCLR, ~1U);
+			return -ETIMEDOUT;
+		}
+	}
+
+	inv_dcache_range(utmrl_base, UTMRD_SIZE);
+	if (hd->ocs != OCS_SUCCESS) {
+		return -EIO;
+	}
+
+	/* The task may have completed before it could be aborted */
+	service = be32toh(resp->output_param1) & TM_SERVICE_MASK;
+	if ((service != TM_SERVICE_COMPLETE) &&
+	    (service != TM_SERVICE_SUCCEEDED)) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Abort the requests still in flight */
+static void ufs_clear_slots(uint8_t lun, uint32_t slots)
+{
+	uint64_t timeout;
+	unsigned int slot;
+
+	if (slots == 0U) {
+		return;
+	}
+
+	for (slot = 0U; slot < (unsigned int)nutrs; slot++) {
+		if (((slots & (1U << slot)) != 0U) &&
+		    (ufs_abort_task(lun, slot) != 0)) {
+			WARN("UFS: Failed to abort slot %u\n", slot);
+		}
+	}
+
+	/* Writing 0 to a bit of UTRLCLR clears the slot */
+	mmio_write_32(ufs_params.reg_base + UTRLCLR, ~slots);
+
+	timeout = timeout_init_us(CMD_TIMEOUT_MS * 1000U);
+	while ((mmio_read_32(ufs_params.reg_base + UTRLDBR) & slots) != 0U) {
+		if (timeout_elapsed(timeout)) {
+			WARN("UFS: Failed to clear slots 0x%x\n", slots);
+			break;
+		}
+	}
+}
+
+static int ufs_send_cmd(utp_utrd_t *utrd, uint8_t cmd_op, uint8_t lun, int lba, uintptr_t buf,
+			size_t length)
 {
 	int result, i;
 
 	for (i = 0; i < UFS_CMD_RETRIES; ++i) {
-		get_utrd(utrd);
+		get_utrd(utrd, 0U);
 		result = ufs_prepare_cmd(utrd, cmd_op, lun, lba, buf, length);
 		assert(result == 0);
 		ufs_send_request(utrd->task_tag);
@@ -671,7 +876,7 @@ static void ufs_send_cmd(utp_utrd_t *utrd, uint8_t cmd_op, uint8_t lun, int lba,
 		}
 	}
 	assert(result == 0);
-	(void)result;
+	return result;
 }
 
 #ifdef UFS_RESP_DEBUG
@@ -713,7 +918,7 @@ static void ufs_verify_init(void)
 	utp_utrd_t utrd;
 	int result;
 
-	get_utrd(&utrd);
+	get_utrd(&utrd, 0U);
 	ufs_prepare_nop_out(&utrd);
 	ufs_send_request(utrd.task_tag);
 	result = ufs_check_resp(&utrd, NOP_IN_UPIU, NOP_OUT_TIMEOUT_MS);
@@ -724,7 +929,7 @@ static void ufs_verify_init(void)
 static void ufs_verify_ready(void)
 {
 	utp_utrd_t utrd;
-	ufs_send_cmd(&utrd, CDBCMD_TEST_UNIT_READY, 0, 0, 0, 0);
+	(void)ufs_send_cmd(&utrd, CDBCMD_TEST_UNIT_READY, 0, 0, 0, 0);
 }
 
 static void ufs_query(uint8_t op, uint8_t idn, uint8_t index, uint8_t sel,
@@ -746,7 +951,7 @@ static void ufs_query(uint8_t op, uint8_t idn, uint8_t index, uint8_t sel,
 		/* Do nothing in default case */
 		break;
 	}
-	get_utrd(&utrd);
+	get_utrd(&utrd, 0U);
 	ufs_prepare_query(&utrd, op, idn, index, sel, buf, size);
 	ufs_send_request(utrd.task_tag);
 	result = ufs_check_resp(&utrd, QUERY_RESPONSE_UPIU, QUERY_REQ_TIMEOUT_MS);
@@ -839,8 +1044,8 @@ static int ufs_read_capacity(int lun, unsigned int *num, unsigned int *size)
 	buf = (buf + CACHE_WRITEBACK_GRANULE - 1) &
 	      ~(CACHE_WRITEBACK_GRANULE - 1);
 	do {
-		ufs_send_cmd(&utrd, CDBCMD_READ_CAPACITY_10, lun, 0,
-			    buf, READ_CAPACITY_LENGTH);
+		(void)ufs_send_cmd(&utrd, CDBCMD_READ_CAPACITY_10, lun, 0,
+				   buf, READ_CAPACITY_LENGTH);
 #ifdef UFS_RESP_DEBUG
 		dump_upiu(&utrd);
 #endif
@@ -865,16 +1070,103 @@ static int ufs_read_capacity(int lun, unsigned int *num, unsigned int *size)
 	return -ETIMEDOUT;
 }
 
-size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
+/*
+ * Read a large area with a READ(10) command in flight on every queue entry.
+ * Each entry is given the next UFS_QUEUED_READ_SIZE bytes of the area as soon
+ * as its previous command completed, whatever the order in which the commands
+ * complete. Nothing is left in flight on error.
+ */
+static int ufs_read_queued(int lun, int lba, uintptr_t buf, size_t size,
+			   size_t *length_read)
 {
-	utp_utrd_t utrd;
+	size_t offset = 0U;
+	size_t residual = 0U;
+	size_t length;
+	uint32_t in_flight = 0U;
+	uint32_t done;
+	unsigned int entry, slot;
+	utp_utrd_t *utrd;
 	resp_upiu_t *resp;
+	int result = 0;
 
-	assert((ufs_params.reg_base != 0) &&
-	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE));
+	while ((offset < size) || (in_flight != 0U)) {
+		/* Queue the next chunks on the idle entries */
+		for (entry = 0U; entry < queue_depth; entry++) {
+			slot = entry * UTRD_SLOT_STRIDE;
+			if ((offset == size) ||
+			    ((in_flight & (1U << slot)) != 0U)) {
+				continue;
+			}
+
+			length = MIN(size - offset,
+				     (size_t)UFS_QUEUED_READ_SIZE);
+			utrd = &ufs_queue[entry].utrd;
+			ufs_queue[entry].buf = buf + offset;
+			ufs_queue[entry].length = length;
+			get_utrd(utrd, entry);
+			(void)ufs_prepare_cmd(utrd, CDBCMD_READ_10, lun,
+					      lba + (offset >> UFS_BLOCK_SHIFT),
+					      buf + offset, length);
+			if (in_flight == 0U) {
+				ufs_send_request(utrd->task_tag);
+			} else {
+				ufs_queue_request(utrd->task_tag);
+			}
+			in_flight |= 1U << slot;
+			offset += length;
+		}
+
+		result = ufs_wait_for_slots(in_flight, &done);
+		if (result != 0) {
+			break;
+		}
+
+		for (entry = 0U; entry < queue_depth; entry++) {
+			slot = entry * UTRD_SLOT_STRIDE;
+			if ((done & (1U << slot)) == 0U) {
+				continue;
+			}
+
+			in_flight &= ~(1U << slot);
+			utrd = &ufs_queue[entry].utrd;
+			result = ufs_check_utrd(utrd, RESPONSE_UPIU);
+			if (result != 0) {
+				break;
+			}
+
+			/*
+			 * Invalidate prefetched cache contents before cpu
+			 * accesses the buf.
+			 */
+			inv_dcache_range(ufs_queue[entry].buf,
+					 ufs_queue[entry].length);
+			resp = (resp_upiu_t *)utrd->resp_upiu;
+			residual += be32toh(resp->res_trans_cnt);
+		}
+
+		if (result != 0) {
+			break;
+		}
+	}
+
+	if (result != 0) {
+		ufs_clear_slots((uint8_t)lun, in_flight);
+		return result;
+	}
+
+	*length_read = size - residual;
+	return 0;
+}
+
+/* Read an area with a single command */
+static size_t ufs_read_single(int lun, int lba, uintptr_t buf, size_t size)
+{
+	utp_utrd_t utrd;
+	resp_upiu_t *resp;
 
-	ufs_send_cmd(&utrd, CDBCMD_READ_10, lun, lba, buf, size);
+	if (ufs_send_cmd(&utrd, CDBCMD_READ_10, lun, lba, buf, size) != 0) {
+		return 0U;
+	}
 #ifdef UFS_RESP_DEBUG
 	dump_upiu(&utrd);
 #endif
@@ -884,7 +1176,45 @@ size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
 	 */
 	inv_dcache_range(buf, size);
 	resp = (resp_upiu_t *)utrd.resp_upiu;
-	return size - resp->res_trans_cnt;
+	return size - be32toh(resp->res_trans_cnt);
+}
+
+size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
+{
+	size_t length_read;
+	size_t offset;
+	size_t length;
+	int result;
+
+	assert((ufs_params.reg_base != 0) &&
+	       (ufs_params.desc_base != 0) &&
+	       (ufs_params.desc_size >= UFS_DESC_SIZE));
+
+	if ((queue_depth > 1U) && (size > UFS_QUEUED_READ_SIZE)) {
+		result = ufs_read_queued(lun, lba, buf, size, &length_read);
+		if (result == 0) {
+			return length_read;
+		}
+
+		/*
+		 * Read the area again one command at a time. The PRDT of a
+		 * single command may not hold the whole area, as the queue
+		 * entries take a share of the descriptor area.
+		 */
+		WARN("UFS: Queued read failed (%i), retrying\n", result);
+		length_read = 0U;
+		for (offset = 0U; offset < size; offset += length) {
+			length = MIN(size - offset,
+				     (size_t)UFS_QUEUED_READ_SIZE);
+			length_read += ufs_read_single(lun,
+					lba + (offset >> UFS_BLOCK_SHIFT),
+					buf + offset, length);
+		}
+
+		return length_read;
+	}
+
+	return ufs_read_single(lun, lba, buf, size);
 }
 
 size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
@@ -896,12 +1226,14 @@ size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
 	       (ufs_params.desc_base != 0) &&
 	       (ufs_params.desc_size >= UFS_DESC_SIZE));
 
-	ufs_send_cmd(&utrd, CDBCMD_WRITE_10, lun, lba, buf, size);
+	if (ufs_send_cmd(&utrd, CDBCMD_WRITE_10, lun, lba, buf, size) != 0) {
+		return 0U;
+	}
 #ifdef UFS_RESP_DEBUG
 	dump_upiu(&utrd);
 #endif
 	resp = (resp_upiu_t *)utrd.resp_upiu;
-	return size - resp->res_trans_cnt;
+	return size - be32toh(resp->res_trans_cnt);
 }
 
 static int ufs_set_fdevice_init(void)
@@ -928,6 +1260,18 @@ static int ufs_set_fdevice_init(void)
 	return 0;
 }
 
+/* Set the UTMRL base, when reads are queued */
+static void ufs_set_utmrl(void)
+{
+	if (utmrl_base == 0U) {
+		return;
+	}
+
+	mmio_write_32(ufs_params.reg_base + UTMRLBA, utmrl_base & UINT32_MAX);
+	mmio_write_32(ufs_params.reg_base + UTMRLBAU,
+		      (utmrl_base >> 32) & UINT32_MAX);
+}
+
 static void ufs_enum(void)
 {
 	unsigned int blk_num, blk_size;
@@ -937,6 +1281,7 @@ static void ufs_enum(void)
 		      ufs_params.desc_base & UINT32_MAX);
 	mmio_write_32(ufs_params.reg_base + UTRLBAU,
 		      (ufs_params.desc_base >> 32) & UINT32_MAX);
+	ufs_set_utmrl();
 
 	ufs_verify_init();
 	ufs_verify_ready();
@@ -993,8 +1338,25 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 
 	/* 0 means 1 slot */
 	nutrs = (mmio_read_32(ufs_params.reg_base + CAP) & CAP_NUTRS_MASK) + 1;
-	if (nutrs > (ufs_params.desc_size / UFS_DESC_SIZE)) {
-		nutrs = ufs_params.desc_size / UFS_DESC_SIZE;
+	/* Use fewer slots if their descriptors and the UTMRL do not fit */
+	utmrl_base = (ufs_params.desc_base + ufs_params.desc_size -
+		      UTMRD_SIZE) & ~(uintptr_t)(UTMRL_ALIGN - 1);
+	while ((nutrs > 1) &&
+	       ((ALIGN_CDB(nutrs * sizeof(utrd_header_t)) +
+		 UFS_QUEUE_DEPTH((unsigned int)nutrs) * UFS_UCD_SIZE) >
+		(utmrl_base - ufs_params.desc_base))) {
+		nutrs--;
+	}
+	queue_depth = UFS_QUEUE_DEPTH((unsigned int)nutrs);
+	if (queue_depth > 1U) {
+		ucd_base = ufs_params.desc_base +
+			   ALIGN_CDB(nutrs * sizeof(utrd_header_t));
+		ucd_limit = utmrl_base;
+	} else {
+		utmrl_base = 0U;
+		ucd_base = ufs_params.desc_base +
+			   ALIGN_CDB(sizeof(utrd_header_t));
+		ucd_limit = ufs_params.desc_base + ufs_params.desc_size;
 	}
 
 
@@ -1003,6 +1365,7 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 			      ufs_params.desc_base & UINT32_MAX);
 		mmio_write_32(ufs_params.reg_base + UTRLBAU,
 			      (ufs_params.desc_base >> 32) & UINT32_MAX);
+		ufs_set_utmrl();
 
 		result = ufshc_dme_get(0x1571, 0, &data);
 		assert(result == 0);
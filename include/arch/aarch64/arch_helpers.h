@@ -694,6 +694,16 @@ static inline void tlbipaallos(void)
 	__asm__("SYS #6,c8,c1,#4");
 }
 
+/*
+ * Invalidate TLBs of GPT entries by Physical Address range, last level
+ * (TLBI RPALOS, Outer Shareable). The operand holds the range size encoding
+ * in bits [47:44] and bits [51:12] of the base address in bits [39:0].
+ */
+static inline void tlbirpalos(uint64_t xt)
+{
+	__asm__("SYS #6,c8,c4,#7,%0" : : "r" (xt));
+}
+
 /*
  * Invalidate TLBs of GPT entries by Physical address, last level.
  *
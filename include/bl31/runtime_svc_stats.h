@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef RUNTIME_SVC_STATS_H
+#define RUNTIME_SVC_STATS_H
+
+#include <lib/utils_def.h>
+
+/*
+ * Statistics of the SMCs handled by each runtime service, read through the
+ * PMF_SMC_GET_TIMESTAMP_* calls with the PMF_RT_SVC_STATS_SVC_ID service ID.
+ * The timestamp ID selects the counter and the service:
+ *
+ *   TID[7:0]   counter, see below
+ *   TID[15:10] PMF_RT_SVC_STATS_SVC_ID
+ *   TID[22:16] OEN of the service, with the call type in bit 22
+ *
+ * and the MPIDR argument selects the CPU. The counters of all the OENs owned
+ * by a runtime service are shared.
+ *
+ * Latencies are measured with the system counter, from the call to the
+ * handler of the runtime service to its return. Bucket 0 of the histogram
+ * counts the calls that took less than 2^RT_SVC_STATS_BUCKET_SHIFT ticks,
+ * bucket n the calls that took [2^(n + SHIFT - 1), 2^(n + SHIFT)) ticks and
+ * the last bucket all the longer ones.
+ */
+#define RT_SVC_STATS_CALLS		U(0)
+#define RT_SVC_STATS_TICKS		U(1)
+#define RT_SVC_STATS_BUCKET(n)		(U(2) + (n))
+
+#define RT_SVC_STATS_BUCKETS		U(16)
+#define RT_SVC_STATS_BUCKET_SHIFT	U(4)
+#define RT_SVC_STATS_TOTAL_IDS		RT_SVC_STATS_BUCKET(RT_SVC_STATS_BUCKETS)
+
+#define RT_SVC_STATS_OEN_SHIFT		U(16)
+#define RT_SVC_STATS_OEN_MASK		U(0x7F)
+
+/* Number of runtime services that statistics are kept for */
+#ifndef PLAT_RT_SVC_STATS_MAX_SVCS
+#define PLAT_RT_SVC_STATS_MAX_SVCS	U(16)
+#endif
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+/* Called on return from the handler of the runtime service 'index' */
+void rt_svc_stats_record(unsigned int index, uint64_t start);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* RUNTIME_SVC_STATS_H */
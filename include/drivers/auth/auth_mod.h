@@ -9,6 +9,7 @@
 
 #include <common/tbbr/tbbr_img_def.h>
 #include <drivers/auth/auth_common.h>
+#include <drivers/auth/crypto_mod.h>
 #include <drivers/auth/img_parser_mod.h>
 
 #include <lib/utils_def.h>
@@ -55,6 +56,32 @@ int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
 
+#if AUTH_CERT_CACHE
+/* Number of verified certificate signatures kept in the cache */
+#ifndef PLAT_AUTH_CERT_CACHE_ENTRIES
+#define PLAT_AUTH_CERT_CACHE_ENTRIES	U(8)
+#endif
+
+#define AUTH_CERT_CACHE_MAGIC		U(0x43434654)	/* "TFCC" */
+
+/*
+ * Certificates whose signature was verified, identified by a digest of the
+ * certificate and of the public key it was verified with. The cache of a boot
+ * stage is handed over to the next one, which then skips the public key
+ * operations for the same certificates.
+ */
+typedef struct auth_cert_cache {
+	uint32_t magic;
+	uint32_t count;
+	struct {
+		unsigned int img_id;
+		unsigned char digest[CRYPTO_MD_MAX_SIZE];
+	} entries[PLAT_AUTH_CERT_CACHE_ENTRIES];
+} auth_cert_cache_t;
+
+void auth_mod_get_cert_cache(void **cache_addr, size_t *cache_size);
+#endif /* AUTH_CERT_CACHE */
+
 /* Macro to register a CoT defined as an array of auth_img_desc_t pointers */
 #define REGISTER_COT(_cot) \
 	const auth_img_desc_t *const *const cot_desc_ptr = (_cot); \
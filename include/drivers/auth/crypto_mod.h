@@ -79,6 +79,33 @@ typedef struct crypto_lib_desc_s {
 			    unsigned int key_flags, const void *iv,
 			    unsigned int iv_len, const void *tag,
 			    unsigned int tag_len);
+
+	/*
+	 * Calculate a hash incrementally (optional). A single calculation is
+	 * in progress at any time. Return one of the 'enum crypto_ret_value'
+	 * options. hash_finish() releases the calculation context whatever
+	 * the result.
+	 */
+	int (*hash_init)(enum crypto_md_algo md_alg);
+	int (*hash_update)(void *data_ptr, unsigned int data_len);
+	int (*hash_finish)(unsigned char output[CRYPTO_MD_MAX_SIZE]);
+
+	/*
+	 * Authenticated decryption in place, in successive chunks (optional).
+	 * A single decryption is in progress at any time. All the chunks but
+	 * the last must be a multiple of the block size of the cipher. The
+	 * decrypted data must not be trusted before auth_decrypt_finish()
+	 * checked the tag.
+	 * Return one of the 'enum crypto_ret_value' options.
+	 * auth_decrypt_finish() releases the decryption context whatever the
+	 * result.
+	 */
+	int (*auth_decrypt_init)(enum crypto_dec_algo dec_algo,
+				 const void *key, unsigned int key_len,
+				 unsigned int key_flags, const void *iv,
+				 unsigned int iv_len);
+	int (*auth_decrypt_update)(void *data_ptr, size_t len);
+	int (*auth_decrypt_finish)(const void *tag, unsigned int tag_len);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -106,6 +133,12 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 			    unsigned int key_flags, const void *iv,
 			    unsigned int iv_len, const void *tag,
 			    unsigned int tag_len);
+int crypto_mod_auth_decrypt_init(enum crypto_dec_algo dec_algo,
+				 const void *key, unsigned int key_len,
+				 unsigned int key_flags, const void *iv,
+				 unsigned int iv_len);
+int crypto_mod_auth_decrypt_update(void *data_ptr, size_t len);
+int crypto_mod_auth_decrypt_finish(const void *tag, unsigned int tag_len);
 
 #if (CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY) || \
     (CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC)
@@ -118,9 +151,56 @@ int crypto_mod_calc_hash(enum crypto_md_algo alg, void *data_ptr,
 int crypto_mod_convert_pk(void *full_pk_ptr, unsigned int full_pk_len,
 			  void **hashed_pk_ptr, unsigned int *hashed_pk_len);
 
+#if CRYPTO_SUPPORT
+int crypto_mod_hash_init(enum crypto_md_algo alg);
+int crypto_mod_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_hash_finish(unsigned char output[CRYPTO_MD_MAX_SIZE]);
+
+/* Image ID standing for the image selected in the digest cache */
+#define CRYPTO_DIGEST_SELECTED_ID	0xFFFFFFFFU
+
+void crypto_mod_digest_begin(void);
+void crypto_mod_digest_select(unsigned int image_id);
+void crypto_mod_digest_record(enum crypto_md_algo alg, const void *data_ptr,
+			      unsigned int data_len,
+			      const unsigned char digest[CRYPTO_MD_MAX_SIZE]);
+int crypto_mod_digest_lookup(unsigned int image_id, enum crypto_md_algo alg,
+			     const void *data_ptr, unsigned int data_len,
+			     unsigned char output[CRYPTO_MD_MAX_SIZE]);
+void crypto_mod_digest_forget(void);
+#endif /* CRYPTO_SUPPORT */
+
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash, \
 			    _calc_hash, _auth_decrypt, _convert_pk) \
+	REGISTER_CRYPTO_LIB_WITH_HASH_STREAM(_name, _init, _verify_signature, \
+					     _verify_hash, _calc_hash, \
+					     _auth_decrypt, _convert_pk, \
+					     NULL, NULL, NULL)
+
+/* Macro to register a cryptographic library able to hash incrementally */
+#define REGISTER_CRYPTO_LIB_WITH_HASH_STREAM(_name, _init, _verify_signature, \
+					     _verify_hash, _calc_hash, \
+					     _auth_decrypt, _convert_pk, \
+					     _hash_init, _hash_update, \
+					     _hash_finish) \
+	REGISTER_CRYPTO_LIB_WITH_STREAMS(_name, _init, _verify_signature, \
+					 _verify_hash, _calc_hash, \
+					 _auth_decrypt, _convert_pk, \
+					 _hash_init, _hash_update, \
+					 _hash_finish, NULL, NULL, NULL)
+
+/*
+ * Macro to register a cryptographic library able to hash and decrypt
+ * incrementally
+ */
+#define REGISTER_CRYPTO_LIB_WITH_STREAMS(_name, _init, _verify_signature, \
+					 _verify_hash, _calc_hash, \
+					 _auth_decrypt, _convert_pk, \
+					 _hash_init, _hash_update, \
+					 _hash_finish, _auth_decrypt_init, \
+					 _auth_decrypt_update, \
+					 _auth_decrypt_finish) \
 	const crypto_lib_desc_t crypto_lib_desc = { \
 		.name = _name, \
 		.init = _init, \
@@ -128,7 +208,13 @@ int crypto_mod_convert_pk(void *full_pk_ptr, unsigned int full_pk_len,
 		.verify_hash = _verify_hash, \
 		.calc_hash = _calc_hash, \
 		.auth_decrypt = _auth_decrypt, \
-		.convert_pk = _convert_pk \
+		.convert_pk = _convert_pk, \
+		.hash_init = _hash_init, \
+		.hash_update = _hash_update, \
+		.hash_finish = _hash_finish, \
+		.auth_decrypt_init = _auth_decrypt_init, \
+		.auth_decrypt_update = _auth_decrypt_update, \
+		.auth_decrypt_finish = _auth_decrypt_finish \
 	}
 
 extern const crypto_lib_desc_t crypto_lib_desc;
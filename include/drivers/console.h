@@ -30,6 +30,13 @@
 /* Returned by console_xxx() if no registered console implements xxx. */
 #define ERROR_NO_VALID_CONSOLE		(-128)
 
+/* Runtime output of BL31 is buffered per CPU (see console_drain()). */
+#if ENABLE_CONSOLE_BUFFER && defined(IMAGE_BL31)
+#define CONSOLE_BUFFERED		1
+#else
+#define CONSOLE_BUFFERED		0
+#endif
+
 #ifndef __ASSEMBLER__
 
 #include <stdint.h>
@@ -77,9 +84,25 @@ void console_switch_state(unsigned int new_state);
 int console_putc(int c);
 /* Read a character (blocking) from any console registered for current state. */
 int console_getc(void);
-/* Flush all consoles registered for the current state. */
+/*
+ * Flush all consoles registered for the current state, after writing out the
+ * characters buffered by all CPUs if ENABLE_CONSOLE_BUFFER is set.
+ */
 void console_flush(void);
 
+#if CONSOLE_BUFFERED
+/*
+ * Write out the characters buffered by the calling CPU. This waits for the
+ * UARTs, so it is only called on the idle paths and to flush important
+ * messages.
+ */
+void console_drain(void);
+#else
+static inline void console_drain(void)
+{
+}
+#endif
+
 #endif /* __ASSEMBLER__ */
 
 #endif /* CONSOLE_H */
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CONSOLE_BUFFER_H
+#define CONSOLE_BUFFER_H
+
+#include <platform_def.h>
+
+#include <lib/utils_def.h>
+
+/* Size of the console output buffer of each CPU (ENABLE_CONSOLE_BUFFER) */
+#ifndef PLAT_CONSOLE_BUFFER_SIZE
+#define PLAT_CONSOLE_BUFFER_SIZE	U(1024)
+#endif
+
+/*
+ * Layout of the per CPU console buffers, which the crash reporting also
+ * writes out. A buffer is padded to a cache line.
+ */
+#define CONSOLE_BUFFER_T_HEAD		U(0)
+#define CONSOLE_BUFFER_T_TAIL		U(4)
+#define CONSOLE_BUFFER_T_DATA		U(8)
+#define CONSOLE_BUFFER_T_SIZE		(((CONSOLE_BUFFER_T_DATA +	\
+					   PLAT_CONSOLE_BUFFER_SIZE) +	\
+					  (CACHE_WRITEBACK_GRANULE - 1)) & \
+					 ~(CACHE_WRITEBACK_GRANULE - 1))
+
+#endif /* CONSOLE_BUFFER_H */
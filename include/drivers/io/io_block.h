@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -19,6 +19,13 @@ typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/*
+	 * Largest transfer handed to ops in a single call when data moves
+	 * directly between the device and the caller's buffer, as a multiple
+	 * of block_size. Zero disables direct transfers, e.g. when the device
+	 * can only reach the bounce buffer, so that all data goes through it.
+	 */
+	size_t		max_xfer_size;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -82,6 +82,9 @@ int io_dev_init(uintptr_t dev_handle, const uintptr_t init_params);
 /* Close a connection to a device */
 int io_dev_close(uintptr_t dev_handle);
 
+/* Get the type of a device */
+io_type_t io_dev_get_type(uintptr_t dev_handle);
+
 
 /* Synchronous operations */
 int io_open(uintptr_t dev_handle, const uintptr_t spec, uintptr_t *handle);
@@ -31,6 +31,12 @@ struct nand_device {
 	int (*mtd_block_is_bad)(unsigned int block);
 	int (*mtd_read_page)(struct nand_device *nand, unsigned int page,
 			     uintptr_t buffer);
+	/*
+	 * Read several consecutive pages of a block (optional), e.g. with the
+	 * cache read commands of the device.
+	 */
+	int (*mtd_read_pages)(struct nand_device *nand, unsigned int page,
+			      unsigned int nb_pages, uintptr_t buffer);
 };
 
 void plat_get_scratch_buffer(void **buffer_addr, size_t *buf_size);
@@ -58,7 +64,8 @@ int nand_read(unsigned int offset, uintptr_t buffer, size_t length,
 int nand_seek_bb(uintptr_t base, unsigned int offset, size_t *extra_offset);
 
 /*
- * Get NAND device instance
+ * Get NAND device instance, to initialize it. This also empties the cache of
+ * the bad block table of the device.
  *
  * Return: NAND device instance reference
  */
@@ -18,6 +18,8 @@
 #define SPI_NAND_OP_READ_FROM_CACHE	0x03U
 #define SPI_NAND_OP_READ_FROM_CACHE_2X	0x3BU
 #define SPI_NAND_OP_READ_FROM_CACHE_4X	0x6BU
+#define SPI_NAND_OP_READ_CACHE_SEQ	0x31U
+#define SPI_NAND_OP_READ_CACHE_END	0x3FU
 
 /* Configuration register */
 #define SPI_NAND_REG_CFG		0xB0U
@@ -31,6 +33,7 @@
 
 /* Flags for specific configuration */
 #define SPI_NAND_HAS_QE_BIT		BIT(0)
+#define SPI_NAND_HAS_CACHE_READ_SEQ	BIT(1)
 
 struct spinand_device {
 	struct nand_device *nand_dev;
@@ -29,10 +29,24 @@
 #define SPI_NOR_OP_READ_1_2_2	0xBBU	/* Read data bytes (Dual I/O SPI) */
 #define SPI_NOR_OP_READ_1_1_4	0x6BU	/* Read data bytes (Quad Output SPI) */
 #define SPI_NOR_OP_READ_1_4_4	0xEBU	/* Read data bytes (Quad I/O SPI) */
+#define SPI_NOR_OP_READ_1_1_8	0x8BU	/* Read data bytes (Octal Output SPI) */
+#define SPI_NOR_OP_READ_1_8_8	0xCBU	/* Read data bytes (Octal I/O SPI) */
+#define SPI_NOR_OP_READ_SFDP	0x5AU	/* Read SFDP tables */
+
+/* 4-byte address opcodes */
+#define SPI_NOR_OP_READ_4B		0x13U
+#define SPI_NOR_OP_READ_FAST_4B		0x0CU
+#define SPI_NOR_OP_READ_1_1_2_4B	0x3CU
+#define SPI_NOR_OP_READ_1_2_2_4B	0xBCU
+#define SPI_NOR_OP_READ_1_1_4_4B	0x6CU
+#define SPI_NOR_OP_READ_1_4_4_4B	0xECU
+#define SPI_NOR_OP_READ_1_1_8_4B	0x7CU
+#define SPI_NOR_OP_READ_1_8_8_4B	0xCCU
 
 /* Flags for NOR specific configuration */
 #define SPI_NOR_USE_FSR		BIT(0)
 #define SPI_NOR_USE_BANK	BIT(1)
+#define SPI_NOR_NO_SFDP		BIT(2)	/* Keep the platform read_op */
 
 struct nor_device {
 	struct spi_mem_op read_op;
@@ -49,6 +63,9 @@ int spi_nor_init(unsigned long long *device_size, unsigned int *erase_size);
 
 /*
  * Platform can implement this to override default NOR instance configuration.
+ * Unless SPI_NOR_NO_SFDP is set, the read_op is then replaced by the fastest
+ * read mode described in the SFDP tables of the device that the bus supports,
+ * and the size is taken from the SFDP tables if it is left to 0.
  *
  * @device: target NOR instance.
  * Return 0 on success, negative value otherwise.
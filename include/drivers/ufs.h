@@ -152,10 +152,12 @@
 #define TRANS_TYPE_CODE_MASK		0x3F
 #define QUERY_RESPONSE_UPIU		(0x36 << 0)
 #define READY_TO_TRANSACTION_UPIU	(0x31 << 0)
+#define TASK_MAN_RESP_UPIU		(0x24 << 0)
 #define DATA_IN_UPIU			(0x22 << 0)
 #define RESPONSE_UPIU			(0x21 << 0)
 #define NOP_IN_UPIU			(0x20 << 0)
 #define QUERY_REQUEST_UPIU		(0x16 << 0)
+#define TASK_MAN_REQ_UPIU		(0x04 << 0)
 #define DATA_OUT_UPIU			(0x02 << 0)
 #define CMD_UPIU			(0x01 << 0)
 #define NOP_OUT_UPIU			(0x00 << 0)
@@ -169,6 +171,14 @@
 #define OCS_FATAL_ERROR			0x6
 #define OCS_MASK			0xF
 
+/* Task Management Function */
+#define TM_FUNC_ABORT_TASK		0x01
+
+/* Task Management Service Response */
+#define TM_SERVICE_COMPLETE		0x00
+#define TM_SERVICE_SUCCEEDED		0x08
+#define TM_SERVICE_MASK			0xFF
+
 /* UIC Command */
 #define DME_GET				0x01
 #define DME_SET				0x02
@@ -428,6 +438,46 @@ typedef struct cmd_upiu {
 	uint8_t		cdb[16];	/* little endian */
 } cmd_upiu_t;	/* 32 bytes with big endian except for cdb[] */
 
+/* Task Management Request UPIU */
+typedef struct tm_req_upiu {
+	uint8_t		trans_type;
+	uint8_t		flags;
+	uint8_t		lun;
+	uint8_t		task_tag;
+	uint8_t		reserved0;
+	uint8_t		tm_function;
+	uint8_t		reserved1;
+	uint8_t		reserved2;
+	uint8_t		total_ehs_len;
+	uint8_t		reserved3;
+	uint16_t	data_segment_len;
+	uint32_t	input_param1;	/* LUN of the task */
+	uint32_t	input_param2;	/* Task tag of the task */
+	uint32_t	input_param3;
+	uint32_t	reserved4;
+	uint32_t	reserved5;
+} tm_req_upiu_t;	/* 32 bytes with big endian */
+
+/* Task Management Response UPIU */
+typedef struct tm_resp_upiu {
+	uint8_t		trans_type;
+	uint8_t		flags;
+	uint8_t		lun;
+	uint8_t		task_tag;
+	uint8_t		reserved0;
+	uint8_t		reserved1;
+	uint8_t		response;
+	uint8_t		reserved2;
+	uint8_t		total_ehs_len;
+	uint8_t		reserved3;
+	uint16_t	data_segment_len;
+	uint32_t	output_param1;	/* Service response */
+	uint32_t	output_param2;
+	uint32_t	reserved4;
+	uint32_t	reserved5;
+	uint32_t	reserved6;
+} tm_resp_upiu_t;	/* 32 bytes with big endian */
+
 typedef struct query_desc {
 	uint8_t		opcode;
 	uint8_t		idn;
@@ -540,6 +590,7 @@ typedef struct utp_utrd {
 	size_t		size_upiu;
 	size_t		size_resp_upiu;
 	size_t		prdt_length;
+	uintptr_t	prdt_limit;	/* End of the space for the PRDT */
 	int		task_tag;
 } utp_utrd_t;
 
@@ -45,6 +45,14 @@ void cm_el2_sysregs_context_save(uint32_t security_state);
 void cm_el2_sysregs_context_restore(uint32_t security_state);
 #endif
 
+#if CTX_INCLUDE_EL2_REGS && CTX_EL2_SKIP_UNCHANGED_REGS
+void cm_el2_sysregs_context_invalidate(void);
+#else
+static inline void cm_el2_sysregs_context_invalidate(void)
+{
+}
+#endif
+
 void cm_el1_sysregs_context_save(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
 void cm_set_elr_el3(uint32_t security_state, uintptr_t entrypoint);
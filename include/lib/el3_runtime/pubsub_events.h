@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -17,6 +17,13 @@
  */
 REGISTER_PUBSUB_EVENT(psci_cpu_on_finish);
 
+/*
+ * Event published when a CPU requests a power down state via the PSCI CPU
+ * SUSPEND API, before any PSCI lock is taken. The suspend may still be
+ * abandoned afterwards.
+ */
+REGISTER_PUBSUB_EVENT(psci_suspend_pwrdown_prepare);
+
 /*
  * These events are published before/after a CPU has been powered down/up
  * via the PSCI CPU SUSPEND API.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -258,17 +258,28 @@ int gpt_enable(void);
  */
 void gpt_disable(void);
 
+/*
+ * Largest region that a single granule transition request may cover. This
+ * bounds the time for which the GPT lock is held and the amount of cache
+ * maintenance done by one call; callers transitioning more memory than this
+ * must split the request.
+ */
+#define GPT_MAX_TRANSITION_SIZE		(UL(1) << 21)
+
 /*
  * This function is the core of the granule transition service. When a granule
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A request may cover several contiguous granules. The transition is all or
+ * nothing: if any granule in the range is not in the expected state then no
+ * granule is transitioned.
  *
  * Parameters
  *   base: Base address of the region to transition, must be aligned to granule
  *         size.
- *   size: Size of region to transition, must be aligned to granule size.
+ *   size: Size of region to transition, must be aligned to granule size and
+ *         no larger than GPT_MAX_TRANSITION_SIZE.
  *   src_sec_state: Security state of the originating SMC invoking the API.
  *
  * Return
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2020, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -53,6 +53,9 @@
 /* Following are the supported PMF service IDs */
 #define PMF_PSCI_STAT_SVC_ID	0
 #define PMF_RT_INSTR_SVC_ID	1
+#define PMF_RT_SVC_STATS_SVC_ID	2
+#define PMF_SPMC_DIR_MSG_SVC_ID	3
+#define PMF_TRNG_STATS_SVC_ID	4
 
 /*******************************************************************************
  * Function & variable prototypes
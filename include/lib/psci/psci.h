@@ -30,6 +30,11 @@
 /* This is the power level corresponding to a CPU */
 #define PSCI_CPU_PWR_LVL	U(0)
 
+/* Number of local power states of a level that PSCI_STAT keeps track of */
+#ifndef PLAT_MAX_PWR_LVL_STATES
+#define PLAT_MAX_PWR_LVL_STATES	U(2)
+#endif
+
 /*
  * The maximum power level supported by PSCI. Since PSCI CPU_SUSPEND
  * uses the old power_state parameter format which has 2 bits to specify the
@@ -379,6 +384,41 @@ int psci_set_suspend_mode(unsigned int mode);
 void __dead2 psci_power_down_wfi(void);
 void psci_arch_setup(void);
 
+#if ENABLE_PSCI_STAT
+/*******************************************************************************
+ * Snapshot of the PSCI_STAT counters of all the power domains, so that they
+ * can be read at once rather than with a PSCI_STAT_RESIDENCY/COUNT call per
+ * CPU and state. The statistics of a state are indexed as returned by the
+ * 'get_pwr_lvl_state_idx' platform hook. Each counter is read atomically but
+ * the snapshot as a whole is not taken under any lock.
+ ******************************************************************************/
+#define PSCI_STAT_DUMP_VERSION	U(1)
+
+typedef struct psci_stat_dump_stat {
+	uint64_t residency;
+	uint64_t count;
+} psci_stat_dump_stat_t;
+
+typedef struct psci_stat_dump_domain {
+	uint32_t level;
+	uint32_t parent_node;
+	uint32_t cpu_start_idx;
+	uint32_t ncpus;
+	psci_stat_dump_stat_t stat[PLAT_MAX_PWR_LVL_STATES];
+} psci_stat_dump_domain_t;
+
+typedef struct psci_stat_dump {
+	uint32_t version;
+	uint32_t cpu_count;
+	uint32_t non_cpu_count;
+	uint32_t state_count;
+	psci_stat_dump_stat_t cpu[PLATFORM_CORE_COUNT][PLAT_MAX_PWR_LVL_STATES];
+	psci_stat_dump_domain_t non_cpu[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+} psci_stat_dump_t;
+
+void psci_stat_dump(psci_stat_dump_t *dump);
+#endif /* ENABLE_PSCI_STAT */
+
 #endif /*__ASSEMBLER__*/
 
 #endif /* PSCI_H */
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TICKET_LOCK_H
+#define TICKET_LOCK_H
+
+#ifndef __ASSEMBLER__
+
+#include <stdint.h>
+
+/*
+ * Ticket lock, granted in the order it was requested. A CPU takes a ticket by
+ * incrementing 'next' and waits in WFE until 'owner' reaches it, so acquiring
+ * the lock costs a single atomic operation whatever the number of CPUs.
+ *
+ * Like spinlocks, ticket locks rely on exclusive accesses and must only be
+ * used by CPUs which are coherent with each other and have their caches
+ * enabled.
+ */
+typedef struct ticket_lock {
+	volatile uint16_t owner;
+	volatile uint16_t next;
+} ticket_lock_t;
+
+void ticket_lock(ticket_lock_t *lock);
+void ticket_unlock(ticket_lock_t *lock);
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TICKET_LOCK_H */
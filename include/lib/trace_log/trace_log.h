@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <platform_def.h>
+
+#include <cdefs.h>
+#include <lib/utils_def.h>
+
+/*
+ * The trace log is a binary log of events for BL31. An event only consists of
+ * a timestamp, the identifier of its format string and the raw values of its
+ * arguments, which makes recording it much cheaper than printing a message.
+ * The format strings are kept in the ELF file only, in the non-loaded
+ * .trace_fmt section, and the events are identified by the offset of their
+ * format string in this section. tools/trace_log/trace_log_decode.py rebuilds
+ * the messages from a dump of the trace buffer and the BL31 ELF file.
+ *
+ * The buffer is exposed through debugfs as /dev/trace when USE_DEBUGFS is set.
+ */
+
+#define TRACE_LOG_MAGIC			U(0x4c544654)	/* "TFTL" */
+#define TRACE_LOG_VERSION		U(1)
+
+/* Maximum number of arguments of an event */
+#define TRACE_LOG_MAX_ARGS		U(5)
+
+/* Number of events kept per CPU, must be a power of 2 */
+#ifndef PLAT_TRACE_LOG_ENTRIES
+#define PLAT_TRACE_LOG_ENTRIES		U(64)
+#endif
+
+#ifndef __ASSEMBLER__
+
+/* Event as laid out in the trace buffer */
+typedef struct trace_log_entry {
+	/* Value of the system counter when the event was recorded */
+	uint64_t timestamp;
+	/* Offset of the format string in the .trace_fmt section */
+	uint64_t fmt_id;
+	/* Sequence number of the event on its CPU, starting at 1, 0 if unused */
+	uint32_t seq;
+	uint32_t nargs;
+	uint64_t args[TRACE_LOG_MAX_ARGS];
+} trace_log_entry_t;
+
+typedef struct trace_log_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t cpu_count;
+	uint32_t entries_per_cpu;
+	uint32_t entry_size;
+	uint32_t max_args;
+} trace_log_header_t;
+
+/* Trace buffer, with a ring of events for each CPU */
+typedef struct trace_log_buffer {
+	trace_log_header_t header;
+	trace_log_entry_t entries[PLATFORM_CORE_COUNT][PLAT_TRACE_LOG_ENTRIES];
+} trace_log_buffer_t;
+
+#if ENABLE_TRACE_LOG && defined(IMAGE_BL31)
+
+extern trace_log_buffer_t trace_log_buffer;
+
+void trace_log_init(void);
+void trace_log_record(uintptr_t fmt_id, unsigned int nargs, ...);
+
+/* Count the arguments of an event, up to TRACE_LOG_MAX_ARGS */
+#define TRACE_LOG_NARGS(...)						\
+	TRACE_LOG_NARGS_(0, ##__VA_ARGS__, 5, 4, 3, 2, 1, 0)
+#define TRACE_LOG_NARGS_(_0, _1, _2, _3, _4, _5, n, ...)	n
+
+/* Pass each argument of an event as a full register */
+#define TRACE_LOG_ARGS(n, ...)		TRACE_LOG_ARGS_(n, ##__VA_ARGS__)
+#define TRACE_LOG_ARGS_(n, ...)		TRACE_LOG_ARGS_##n(__VA_ARGS__)
+#define TRACE_LOG_ARGS_0()
+#define TRACE_LOG_ARGS_1(a)		, (u_register_t)(a)
+#define TRACE_LOG_ARGS_2(a, ...)	TRACE_LOG_ARGS_1(a) TRACE_LOG_ARGS_1(__VA_ARGS__)
+#define TRACE_LOG_ARGS_3(a, ...)	TRACE_LOG_ARGS_1(a) TRACE_LOG_ARGS_2(__VA_ARGS__)
+#define TRACE_LOG_ARGS_4(a, ...)	TRACE_LOG_ARGS_1(a) TRACE_LOG_ARGS_3(__VA_ARGS__)
+#define TRACE_LOG_ARGS_5(a, ...)	TRACE_LOG_ARGS_1(a) TRACE_LOG_ARGS_4(__VA_ARGS__)
+
+/*
+ * Record an event. The format is the same as for printf(), but '%s' arguments
+ * can only be decoded when they point to read-only data of BL31.
+ *
+ * The identifier of the event is read from memory rather than built into the
+ * instruction stream, as the .trace_fmt section is not within reach of the
+ * PC-relative addressing used by the code.
+ */
+#define TRACE_EVENT(fmt, ...)						\
+	do {								\
+		static const char trace_fmt_[]				\
+			__section(".trace_fmt") __used = fmt;		\
+		static const volatile uintptr_t trace_id_ =		\
+			(uintptr_t)trace_fmt_;				\
+		if (false) {						\
+			(void)printf(fmt, ##__VA_ARGS__);		\
+		}							\
+		trace_log_record(trace_id_,				\
+				 TRACE_LOG_NARGS(__VA_ARGS__)		\
+				 TRACE_LOG_ARGS(TRACE_LOG_NARGS(__VA_ARGS__), \
+						##__VA_ARGS__));	\
+	} while (false)
+
+#else
+
+#define TRACE_EVENT(fmt, ...)						\
+	do {								\
+		if (false) {						\
+			(void)printf(fmt, ##__VA_ARGS__);		\
+		}							\
+	} while (false)
+
+#endif /* ENABLE_TRACE_LOG && defined(IMAGE_BL31) */
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TRACE_LOG_H */
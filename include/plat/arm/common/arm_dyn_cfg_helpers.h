@@ -13,5 +13,7 @@
 int arm_dyn_tb_fw_cfg_init(void *dtb, int *node);
 int arm_set_dtb_mbedtls_heap_info(void *dtb, void *heap_addr,
 	size_t heap_size);
+int arm_set_dtb_auth_cert_cache_info(void *dtb, void *cache_addr,
+	size_t cache_size);
 
 #endif /* ARM_DYN_CFG_HELPERS_H */
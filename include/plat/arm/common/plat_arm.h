@@ -269,6 +269,8 @@ bool arm_io_is_toc_valid(void);
 void arm_bl2_dyn_cfg_init(void);
 void arm_bl1_set_mbedtls_heap(void);
 int arm_get_mbedtls_heap(void **heap_addr, size_t *heap_size);
+void arm_bl1_set_auth_cert_cache(void);
+int arm_get_auth_cert_cache(void **cache_addr, size_t *cache_size);
 
 #if MEASURED_BOOT
 int arm_set_tos_fw_info(uintptr_t log_addr, size_t log_size);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2021-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -128,6 +128,25 @@
 					/* 0x1B3 */
 #define RMM_ATTEST_GET_PLAT_TOKEN	SMC64_RMMD_EL3_FID(U(3))
 
+/*
+ * Delegate / undelegate a range of contiguous granules.
+ * The arguments to these SMCs are :
+ *    arg0 - Function ID.
+ *    arg1 - Base PA of the range, aligned to the granule size.
+ *    arg2 - Size of the range (in bytes), a multiple of the granule size.
+ * The return arguments are :
+ *    ret0 - Status / error.
+ *    ret1 - Number of bytes transitioned from arg1 if successful.
+ *
+ * EL3 transitions the range up to the next GPT_MAX_TRANSITION_SIZE boundary
+ * at most, so that the time spent in EL3 by a single call is bounded. When
+ * ret1 is smaller than arg2 the caller resumes the transition by issuing the
+ * SMC again for the remaining part of the range.
+ */
+					/* 0x1B4 - 0x1B5 */
+#define RMM_GTSI_DELEGATE_RANGE		SMC64_RMMD_EL3_FID(U(4))
+#define RMM_GTSI_UNDELEGATE_RANGE	SMC64_RMMD_EL3_FID(U(5))
+
 /* ECC Curve types for attest key generation */
 #define ATTEST_KEY_CURVE_ECC_SECP384R1		0
 
@@ -152,7 +171,7 @@
  * Increase this when a bug is fixed, or a feature is added without
  * breaking compatibility.
  */
-#define RMM_EL3_IFC_VERSION_MINOR	(U(2))
+#define RMM_EL3_IFC_VERSION_MINOR	(U(3))
 
 #define RMM_EL3_INTERFACE_VERSION				\
 	(((RMM_EL3_IFC_VERSION_MAJOR << 16) & 0x7FFFF) |	\
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,10 +7,24 @@
 #ifndef SPMC_SVC_H
 #define SPMC_SVC_H
 
+#include <lib/utils_def.h>
+
+/*
+ * Counters of the direct messages handled by each SP, read through the
+ * PMF_SMC_GET_TIMESTAMP_* calls with the PMF_SPMC_DIR_MSG_SVC_ID service ID
+ * when ENABLE_PMF is set. TID[7:0] selects the counter, TID[22:16] the index
+ * of the SP in the SPMC and the MPIDR argument the CPU.
+ */
+#define SPMC_DIR_MSG_STATS_REQS		U(0)
+#define SPMC_DIR_MSG_STATS_RESPS	U(1)
+#define SPMC_DIR_MSG_STATS_TOTAL_IDS	U(2)
+
+#define SPMC_DIR_MSG_STATS_SP_SHIFT	U(16)
+#define SPMC_DIR_MSG_STATS_SP_MASK	U(0x7F)
+
 #ifndef __ASSEMBLER__
 #include <stdint.h>
 
-#include <lib/utils_def.h>
 #include <services/ffa_svc.h>
 #include <services/spm_core_manifest.h>
 
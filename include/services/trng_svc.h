@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, ARM Limited. All rights reserved.
+ * Copyright (c) 2021-2023, ARM Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -34,6 +34,23 @@
 #define TRNG_RND32_ENTROPY_MAXBITS	(96U)
 #define TRNG_RND64_ENTROPY_MAXBITS	(192U)
 
+/*
+ * Statistics of the entropy pool of each CPU, read through the
+ * PMF_SMC_GET_TIMESTAMP_* calls with the PMF_TRNG_STATS_SVC_ID service ID when
+ * ENABLE_PMF is set. TID[7:0] selects the counter and the MPIDR argument the
+ * CPU.
+ *
+ * HITS:     TRNG_RND calls served from the pool.
+ * STALLS:   TRNG_RND calls that waited for the entropy source.
+ * FAILURES: TRNG_RND calls that failed as the source ran out of entropy.
+ * PREFILLS: refills of the pool on entry into a power down state.
+ */
+#define TRNG_STATS_HITS			U(0)
+#define TRNG_STATS_STALLS		U(1)
+#define TRNG_STATS_FAILURES		U(2)
+#define TRNG_STATS_PREFILLS		U(3)
+#define TRNG_STATS_TOTAL_IDS		U(4)
+
 /* Public API to perform the initial TRNG entropy setup */
 void trng_setup(void);
 
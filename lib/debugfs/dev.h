@@ -34,6 +34,8 @@ enum {
 	DEV_ROOT_QDEV,
 	DEV_ROOT_QFIP,
 	DEV_ROOT_QBLOBS,
+	DEV_ROOT_QTRACE,
+	DEV_ROOT_QPSCISTAT,
 	DEV_ROOT_QBLOBCTL,
 	DEV_ROOT_QPSCI
 };
@@ -7,6 +7,8 @@
 #include <assert.h>
 #include <common/debug.h>
 #include <lib/debugfs.h>
+#include <lib/psci/psci.h>
+#include <lib/trace_log/trace_log.h>
 
 #include "blobs.h"
 #include "dev.h"
@@ -20,7 +22,20 @@ static const dirtab_t dirtab[] = {
 	{"fip",   CHDIR | DEV_ROOT_QFIP,   0, O_READ}
 };
 
+#if ENABLE_PSCI_STAT
+/* Snapshot of the PSCI statistics, taken when /dev/psci_stat is read from 0 */
+static psci_stat_dump_t psci_stat_snapshot;
+#endif
+
 static const dirtab_t devfstab[] = {
+#if ENABLE_TRACE_LOG
+	{"trace", DEV_ROOT_QTRACE, sizeof(trace_log_buffer), O_READ,
+	 &trace_log_buffer},
+#endif
+#if ENABLE_PSCI_STAT
+	{"psci_stat", DEV_ROOT_QPSCISTAT, sizeof(psci_stat_snapshot), O_READ,
+	 &psci_stat_snapshot},
+#endif
 };
 
 /*******************************************************************************
@@ -72,6 +87,24 @@ static int rootread(chan_t *channel, void *buf, int size)
 		return dirread(channel, dir, NULL, 0, rootgen);
 	}
 
+#if ENABLE_TRACE_LOG
+	if (channel->qid == DEV_ROOT_QTRACE) {
+		return buf_to_channel(channel, buf, &trace_log_buffer, size,
+				      sizeof(trace_log_buffer));
+	}
+#endif
+
+#if ENABLE_PSCI_STAT
+	if (channel->qid == DEV_ROOT_QPSCISTAT) {
+		if (channel->offset == 0) {
+			psci_stat_dump(&psci_stat_snapshot);
+		}
+
+		return buf_to_channel(channel, buf, &psci_stat_snapshot, size,
+				      sizeof(psci_stat_snapshot));
+	}
+#endif
+
 	/* Only makes sense when using debug language */
 	assert(channel->qid != DEV_ROOT_QBLOBCTL);
 
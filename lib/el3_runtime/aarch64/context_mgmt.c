@@ -31,7 +31,10 @@
 #include <lib/extensions/sys_reg_trace.h>
 #include <lib/extensions/trbe.h>
 #include <lib/extensions/trf.h>
+#include <lib/pmf/pmf.h>
+#include <lib/runtime_instr.h>
 #include <lib/utils.h>
+#include <plat/common/platform.h>
 
 #if ENABLE_FEAT_TWED
 /* Make sure delay value fits within the range(0-15) */
@@ -41,6 +44,99 @@ CASSERT(((TWED_DELAY & ~SCR_TWEDEL_MASK) == 0U), assert_twed_delay_value_check);
 static void manage_extensions_nonsecure(cpu_context_t *ctx);
 static void manage_extensions_secure(cpu_context_t *ctx);
 
+#if CTX_INCLUDE_EL2_REGS
+/*
+ * Groups of EL2 registers which are only restored when their saved values
+ * differ from the live ones. Each group must be contiguous in the context.
+ */
+#define CTX_EL2_MPAM_START	CTX_MPAM2_EL2
+#define CTX_EL2_MPAM_END	(CTX_MPAMVPMV_EL2 + 8U)
+#define CTX_EL2_FGT_START	CTX_HDFGRTR_EL2
+#define CTX_EL2_FGT_END		(CTX_HFGWTR_EL2 + 8U)
+
+#define CTX_EL2_NEXT(prev, reg)	((reg) == ((prev) + 8U))
+
+CASSERT(CTX_EL2_NEXT(CTX_MPAM2_EL2, CTX_MPAMHCR_EL2) &&
+	CTX_EL2_NEXT(CTX_MPAMHCR_EL2, CTX_MPAMVPM0_EL2) &&
+	CTX_EL2_NEXT(CTX_MPAMVPM0_EL2, CTX_MPAMVPM1_EL2) &&
+	CTX_EL2_NEXT(CTX_MPAMVPM1_EL2, CTX_MPAMVPM2_EL2) &&
+	CTX_EL2_NEXT(CTX_MPAMVPM2_EL2, CTX_MPAMVPM3_EL2) &&
+	CTX_EL2_NEXT(CTX_MPAMVPM3_EL2, CTX_MPAMVPM4_EL2) &&
+	CTX_EL2_NEXT(CTX_MPAMVPM4_EL2, CTX_MPAMVPM5_EL2) &&
+	CTX_EL2_NEXT(CTX_MPAMVPM5_EL2, CTX_MPAMVPM6_EL2) &&
+	CTX_EL2_NEXT(CTX_MPAMVPM6_EL2, CTX_MPAMVPM7_EL2) &&
+	CTX_EL2_NEXT(CTX_MPAMVPM7_EL2, CTX_MPAMVPMV_EL2),
+	assert_ctx_el2_mpam_regs_contiguous);
+
+CASSERT(CTX_EL2_NEXT(CTX_HDFGRTR_EL2, CTX_HAFGRTR_EL2) &&
+	CTX_EL2_NEXT(CTX_HAFGRTR_EL2, CTX_HDFGWTR_EL2) &&
+	CTX_EL2_NEXT(CTX_HDFGWTR_EL2, CTX_HFGITR_EL2) &&
+	CTX_EL2_NEXT(CTX_HFGITR_EL2, CTX_HFGRTR_EL2) &&
+	CTX_EL2_NEXT(CTX_HFGRTR_EL2, CTX_HFGWTR_EL2),
+	assert_ctx_el2_fgt_regs_contiguous);
+
+#if CTX_EL2_SKIP_UNCHANGED_REGS
+/*
+ * EL2 context which was last saved from, or restored to, the EL2 registers of
+ * each CPU. The registers whose value is the same in this context and in the
+ * context being restored do not need to be written. NULL when the content of
+ * the registers is unknown.
+ */
+static struct {
+	const el2_sysregs_t *ctx;
+} __aligned(CACHE_WRITEBACK_GRANULE) el2_live_ctx[PLATFORM_CORE_COUNT];
+
+static void el2_live_ctx_set(const el2_sysregs_t *ctx)
+{
+	el2_live_ctx[plat_my_core_pos()].ctx = ctx;
+}
+
+/*
+ * Forget the EL2 context 'ctx' on every CPU, as EL3 has changed its saved
+ * values behind the registers it was restored to.
+ */
+static void el2_live_ctx_forget(const el2_sysregs_t *ctx)
+{
+	unsigned int i;
+
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		if (el2_live_ctx[i].ctx == ctx) {
+			el2_live_ctx[i].ctx = NULL;
+		}
+	}
+}
+
+/*
+ * Return true if the registers of 'ctx' in the range [start, end) must be
+ * written to restore it, i.e. unless they hold the same values in the live
+ * context.
+ */
+static bool el2_regs_need_restore(const el2_sysregs_t *ctx, size_t start,
+				  size_t end)
+{
+	const el2_sysregs_t *live = el2_live_ctx[plat_my_core_pos()].ctx;
+
+	if (live == NULL) {
+		return true;
+	}
+
+	return (live != ctx) &&
+	       (memcmp((const uint8_t *)live + start,
+		       (const uint8_t *)ctx + start, end - start) != 0);
+}
+#else
+static inline void el2_live_ctx_forget(const el2_sysregs_t *ctx)
+{
+}
+
+static inline bool el2_regs_need_restore(const el2_sysregs_t *ctx,
+					 size_t start, size_t end)
+{
+	return true;
+}
+#endif /* CTX_EL2_SKIP_UNCHANGED_REGS */
+#endif /* CTX_INCLUDE_EL2_REGS */
+
 static void setup_el1_context(cpu_context_t *ctx, const struct entry_point_info *ep)
 {
 	u_register_t sctlr_elx, actlr_elx;
@@ -292,6 +388,9 @@ static void setup_ns_context(cpu_context_t *ctx, const struct entry_point_info *
 			HFGRTR_EL2_INIT_VAL);
 		write_ctx_reg(get_el2_sysregs_ctx(ctx), CTX_HFGWTR_EL2,
 			HFGWTR_EL2_INIT_VAL);
+
+		/* The saved FGT values no longer match the registers */
+		el2_live_ctx_forget(get_el2_sysregs_ctx(ctx));
 	}
 #endif /* CTX_INCLUDE_EL2_REGS */
 
@@ -546,6 +645,9 @@ void cm_manage_extensions_el3(void)
 	}
 
 	pmuv3_init_el3();
+
+	/* The EL2 registers were reset or written above */
+	cm_el2_sysregs_context_invalidate();
 }
 #endif /* IMAGE_BL31 */
 
@@ -882,6 +984,9 @@ void cm_prepare_el3_exit(uint32_t security_state)
 		} else if (el2_implemented != EL_IMPL_NONE) {
 			init_nonsecure_el2_unused(ctx);
 		}
+
+		/* The EL2 registers no longer match any saved context */
+		cm_el2_sysregs_context_invalidate();
 	}
 
 	cm_el1_sysregs_context_restore(security_state);
@@ -1094,6 +1199,11 @@ void cm_el2_sysregs_context_save(uint32_t security_state)
 {
 	u_register_t scr_el3 = read_scr();
 
+#if ENABLE_RUNTIME_INSTRUMENTATION && defined(IMAGE_BL31)
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_ENTER_EL2_CTX_SAVE,
+			      PMF_NO_CACHE_MAINT);
+#endif
+
 	/*
 	 * Always save the non-secure and realm EL2 context, only save the
 	 * S-EL2 context if S-EL2 is enabled.
@@ -1173,7 +1283,16 @@ void cm_el2_sysregs_context_save(uint32_t security_state)
 			write_ctx_reg(el2_sysregs_ctx, CTX_GCSPR_EL2, read_gcspr_el2());
 			write_ctx_reg(el2_sysregs_ctx, CTX_GCSCR_EL2, read_gcscr_el2());
 		}
+
+#if CTX_EL2_SKIP_UNCHANGED_REGS
+		el2_live_ctx_set(el2_sysregs_ctx);
+#endif
 	}
+
+#if ENABLE_RUNTIME_INSTRUMENTATION && defined(IMAGE_BL31)
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_EXIT_EL2_CTX_SAVE,
+			      PMF_NO_CACHE_MAINT);
+#endif
 }
 
 /*******************************************************************************
@@ -1183,6 +1302,11 @@ void cm_el2_sysregs_context_restore(uint32_t security_state)
 {
 	u_register_t scr_el3 = read_scr();
 
+#if ENABLE_RUNTIME_INSTRUMENTATION && defined(IMAGE_BL31)
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_ENTER_EL2_CTX_RESTORE,
+			      PMF_NO_CACHE_MAINT);
+#endif
+
 	/*
 	 * Always restore the non-secure and realm EL2 context, only restore the
 	 * S-EL2 context if S-EL2 is enabled.
@@ -1201,11 +1325,15 @@ void cm_el2_sysregs_context_restore(uint32_t security_state)
 #if CTX_INCLUDE_MTE_REGS
 		write_tfsr_el2(read_ctx_reg(el2_sysregs_ctx, CTX_TFSR_EL2));
 #endif
-		if (is_feat_mpam_supported()) {
+		if (is_feat_mpam_supported() &&
+		    el2_regs_need_restore(el2_sysregs_ctx, CTX_EL2_MPAM_START,
+					  CTX_EL2_MPAM_END)) {
 			el2_sysregs_context_restore_mpam(el2_sysregs_ctx);
 		}
 
-		if (is_feat_fgt_supported()) {
+		if (is_feat_fgt_supported() &&
+		    el2_regs_need_restore(el2_sysregs_ctx, CTX_EL2_FGT_START,
+					  CTX_EL2_FGT_END)) {
 			el2_sysregs_context_restore_fgt(el2_sysregs_ctx);
 		}
 
@@ -1256,8 +1384,29 @@ void cm_el2_sysregs_context_restore(uint32_t security_state)
 			write_gcscr_el2(read_ctx_reg(el2_sysregs_ctx, CTX_GCSCR_EL2));
 			write_gcspr_el2(read_ctx_reg(el2_sysregs_ctx, CTX_GCSPR_EL2));
 		}
+
+#if CTX_EL2_SKIP_UNCHANGED_REGS
+		el2_live_ctx_set(el2_sysregs_ctx);
+#endif
 	}
+
+#if ENABLE_RUNTIME_INSTRUMENTATION && defined(IMAGE_BL31)
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc, RT_INSTR_EXIT_EL2_CTX_RESTORE,
+			      PMF_NO_CACHE_MAINT);
+#endif
+}
+
+#if CTX_EL2_SKIP_UNCHANGED_REGS
+/*******************************************************************************
+ * Forget which EL2 context the EL2 registers of this CPU hold. To be called
+ * when they are written outside of cm_el2_sysregs_context_restore() or lost,
+ * e.g. when the CPU is powered down.
+ ******************************************************************************/
+void cm_el2_sysregs_context_invalidate(void)
+{
+	el2_live_ctx_set(NULL);
 }
+#endif /* CTX_EL2_SKIP_UNCHANGED_REGS */
 #endif /* CTX_INCLUDE_EL2_REGS */
 
 /*******************************************************************************
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -71,12 +71,22 @@ int fconf_populate_tbbr_dyn_config(uintptr_t config)
 	}
 	tbbr_dyn_config.mbedtls_heap_size = val32;
 
+	/* The cache of verified certificates is optional */
+	if ((fdt_read_uint64(dtb, node, "auth_cert_cache_addr", &val64) == 0) &&
+	    (fdt_read_uint32(dtb, node, "auth_cert_cache_size", &val32) == 0)) {
+		tbbr_dyn_config.auth_cert_cache_addr = (void *)(uintptr_t)val64;
+		tbbr_dyn_config.auth_cert_cache_size = val32;
+	}
+
 	VERBOSE("%s%s%s %u\n", "FCONF: `tbbr.", "disable_auth",
 		"` cell found with value =", tbbr_dyn_config.disable_auth);
 	VERBOSE("%s%s%s %p\n", "FCONF: `tbbr.", "mbedtls_heap_addr",
 		"` cell found with value =", tbbr_dyn_config.mbedtls_heap_addr);
 	VERBOSE("%s%s%s %zu\n", "FCONF: `tbbr.", "mbedtls_heap_size",
 		"` cell found with value =", tbbr_dyn_config.mbedtls_heap_size);
+	VERBOSE("%s%s%s %p\n", "FCONF: `tbbr.", "auth_cert_cache_addr",
+		"` cell found with value =",
+		tbbr_dyn_config.auth_cert_cache_addr);
 
 	return 0;
 }
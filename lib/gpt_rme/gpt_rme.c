@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -14,10 +14,13 @@
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include "gpt_rme_private.h"
+#include <lib/cassert.h>
 #include <lib/gpt_rme/gpt_rme.h>
 #include <lib/smccc.h>
 #include <lib/spinlock.h>
+#include <lib/utils_def.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
+#include <platform_def.h>
 
 #if !ENABLE_RME
 #error "ENABLE_RME must be enabled to use the GPT library."
@@ -954,64 +957,217 @@ int gpt_runtime_init(void)
 }
 
 /*
- * The L1 descriptors are protected by a spinlock to ensure that multiple
- * CPUs do not attempt to change the descriptors at once. In the future it
- * would be better to have separate spinlocks for each L1 descriptor.
+ * The L1 descriptors are protected by an array of spinlocks so that
+ * transitions of unrelated memory can proceed in parallel on different CPUs.
+ * Each GPT_MAX_TRANSITION_SIZE aligned region of the PA space is assigned one
+ * of the locks, which covers all the L1 descriptors of the region since a
+ * descriptor never spans two such regions. A transition request therefore
+ * needs at most two locks. Each lock sits in its own cache line to avoid false
+ * sharing between CPUs.
  */
-static spinlock_t gpt_lock;
+typedef struct gpt_lock {
+	spinlock_t lock;
+} __aligned(CACHE_WRITEBACK_GRANULE) gpt_lock_t;
+
+static gpt_lock_t gpt_locks[GPT_LOCK_COUNT];
+
+CASSERT(GPT_MAX_TRANSITION_SIZE >= (GPT_L1_GPI_COUNT << PGS_64KB_P),
+	assert_gpt_lock_region_covers_l1_desc);
+CASSERT(IS_POWER_OF_TWO(GPT_LOCK_COUNT), assert_gpt_lock_count_power_of_two);
+
+static inline unsigned int gpt_lock_idx(uint64_t pa)
+{
+	return (unsigned int)(pa / GPT_MAX_TRANSITION_SIZE) &
+		(GPT_LOCK_COUNT - 1U);
+}
 
 /*
- * A helper to write the value (target_pas << gpi_shift) to the index of
- * the gpt_l1_addr
+ * Acquire the locks covering [base, base + size). When two locks are needed
+ * they are taken in ascending index order so that concurrent requests cannot
+ * deadlock.
  */
-static inline void write_gpt(uint64_t *gpt_l1_desc, uint64_t *gpt_l1_addr,
-			     unsigned int gpi_shift, unsigned int idx,
-			     unsigned int target_pas)
+static void gpt_lock_range(uint64_t base, size_t size)
+{
+	unsigned int first = gpt_lock_idx(base);
+	unsigned int last = gpt_lock_idx(base + size - 1UL);
+
+	if (first > last) {
+		unsigned int tmp = first;
+
+		first = last;
+		last = tmp;
+	}
+
+	spin_lock(&gpt_locks[first].lock);
+	if (last != first) {
+		spin_lock(&gpt_locks[last].lock);
+	}
+}
+
+/* Release the locks taken by gpt_lock_range(). */
+static void gpt_unlock_range(uint64_t base, size_t size)
 {
-	*gpt_l1_desc &= ~(GPT_L1_GRAN_DESC_GPI_MASK << gpi_shift);
-	*gpt_l1_desc |= ((uint64_t)target_pas << gpi_shift);
-	gpt_l1_addr[idx] = *gpt_l1_desc;
+	unsigned int first = gpt_lock_idx(base);
+	unsigned int last = gpt_lock_idx(base + size - 1UL);
+
+	if (last != first) {
+		spin_unlock(&gpt_locks[last].lock);
+	}
+	spin_unlock(&gpt_locks[first].lock);
 }
 
 /*
- * Helper to retrieve the gpt_l1_* information from the base address
- * returned in gpi_info
+ * Helper to validate the address range of a granule transition request.
  */
-static int get_gpi_params(uint64_t base, gpi_info_t *gpi_info)
+static int check_transition_range(uint64_t base, size_t size)
+{
+	/* Check that base and size are valid */
+	if ((ULONG_MAX - base) < size) {
+		VERBOSE("[GPT] Transition request address overflow!\n");
+		VERBOSE("      Base=0x%" PRIx64 "\n", base);
+		VERBOSE("      Size=0x%lx\n", size);
+		return -EINVAL;
+	}
+
+	/* Make sure base and size are valid. */
+	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
+	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
+	    (size == 0UL) || (size > GPT_MAX_TRANSITION_SIZE) ||
+	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
+		VERBOSE("[GPT] Invalid granule transition address range!\n");
+		VERBOSE("      Base=0x%" PRIx64 "\n", base);
+		VERBOSE("      Size=0x%lx\n", size);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Helper to locate the L1 descriptor holding the GPI of the granule at 'pa'
+ * and to build the mask of the GPI fields of that descriptor which lie within
+ * [pa, end). The address following the last granule covered by the mask is
+ * returned in 'next'. NULL is returned if 'pa' is not covered by an L0 table
+ * descriptor.
+ */
+static uint64_t *get_l1_desc_range(uint64_t pa, uint64_t end, uint64_t *mask,
+				   uint64_t *next)
 {
 	uint64_t gpt_l0_desc, *gpt_l0_base;
+	unsigned int gpi_idx, count;
 
 	gpt_l0_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
-	gpt_l0_desc = gpt_l0_base[GPT_L0_IDX(base)];
+	gpt_l0_desc = gpt_l0_base[GPT_L0_IDX(pa)];
 	if (GPT_L0_TYPE(gpt_l0_desc) != GPT_L0_TYPE_TBL_DESC) {
 		VERBOSE("[GPT] Granule is not covered by a table descriptor!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		return -EINVAL;
+		VERBOSE("      Base=0x%" PRIx64 "\n", pa);
+		return NULL;
+	}
+
+	/* Number of granules of the range held by this descriptor. */
+	gpi_idx = GPT_L1_GPI_IDX(gpt_config.p, pa);
+	count = GPT_L1_GPI_COUNT - gpi_idx;
+	if (((end - pa) >> gpt_config.p) < count) {
+		count = (unsigned int)((end - pa) >> gpt_config.p);
+	}
+
+	if (count == GPT_L1_GPI_COUNT) {
+		*mask = ~0UL;
+	} else {
+		*mask = ((1UL << (count << 2)) - 1UL) << (gpi_idx << 2);
 	}
+	*next = pa + ((uint64_t)count << gpt_config.p);
 
-	/* Get the table index and GPI shift from PA. */
-	gpi_info->gpt_l1_addr = GPT_L0_TBLD_ADDR(gpt_l0_desc);
-	gpi_info->idx = GPT_L1_IDX(gpt_config.p, base);
-	gpi_info->gpi_shift = GPT_L1_GPI_IDX(gpt_config.p, base) << 2;
+	return &(GPT_L0_TBLD_ADDR(gpt_l0_desc))[GPT_L1_IDX(gpt_config.p, pa)];
+}
+
+/*
+ * Helper to check that every granule in [base, base + size) is covered by an
+ * L1 table and currently has the GPI 'gpi'.
+ */
+static int check_gpi_range(uint64_t base, size_t size, unsigned int gpi)
+{
+	uint64_t *gpt_l1_desc, mask, pa, next;
+	uint64_t expected = GPT_BUILD_L1_DESC(gpi);
+
+	for (pa = base; pa < (base + size); pa = next) {
+		gpt_l1_desc = get_l1_desc_range(pa, base + size, &mask, &next);
+		if (gpt_l1_desc == NULL) {
+			return -EINVAL;
+		}
+
+		if (((*gpt_l1_desc ^ expected) & mask) != 0UL) {
+			VERBOSE("[GPT] Granule descriptor 0x%" PRIx64
+				" at 0x%" PRIx64 " not in GPI 0x%x\n",
+				*gpt_l1_desc, pa, gpi);
+			return -EPERM;
+		}
+	}
 
-	gpi_info->gpt_l1_desc = (gpi_info->gpt_l1_addr)[gpi_info->idx];
-	gpi_info->gpi = (gpi_info->gpt_l1_desc >> gpi_info->gpi_shift) &
-		GPT_L1_GRAN_DESC_GPI_MASK;
 	return 0;
 }
 
+/*
+ * Helper to set the GPI of every granule in [base, base + size) to 'gpi'.
+ * Each L1 descriptor is updated with a single write, whatever the number of
+ * its granules within the range. The range must have been validated with
+ * check_gpi_range() beforehand.
+ */
+static void write_gpi_range(uint64_t base, size_t size, unsigned int gpi)
+{
+	uint64_t *gpt_l1_desc, mask, pa, next;
+	uint64_t value = GPT_BUILD_L1_DESC(gpi);
+
+	for (pa = base; pa < (base + size); pa = next) {
+		gpt_l1_desc = get_l1_desc_range(pa, base + size, &mask, &next);
+		assert(gpt_l1_desc != NULL);
+
+		*gpt_l1_desc = (*gpt_l1_desc & ~mask) | (value & mask);
+	}
+}
+
+/*
+ * Helper to invalidate the TLB entries caching GPT information for
+ * [base, base + size). The range is split into the naturally aligned blocks
+ * of the largest sizes that TLBI RPALOS can encode, so that a whole
+ * transition request normally costs a handful of TLBI operations. Completion
+ * must be ensured by the caller with a DSB.
+ */
+static void gpt_tlbi_by_pa_range(uint64_t base, size_t size)
+{
+	/* Range sizes supported by TLBI RPALOS, from SIZE encoding 6 down to 0 */
+	static const unsigned int tlbi_shift[] = {
+		30U, 29U, 25U, 21U, 16U, 14U, 12U
+	};
+	uint64_t pa = base;
+	uint64_t end = base + size;
+	unsigned int i;
+
+	while (pa < end) {
+		for (i = 0U; i < (ARRAY_SIZE(tlbi_shift) - 1U); i++) {
+			if (((pa & ((1UL << tlbi_shift[i]) - 1UL)) == 0UL) &&
+			    ((end - pa) >= (1UL << tlbi_shift[i]))) {
+				break;
+			}
+		}
+
+		tlbirpalos(((uint64_t)(ARRAY_SIZE(tlbi_shift) - 1U - i) <<
+			    GPT_TLBI_RPA_SIZE_SHIFT) |
+			   ((pa >> FOUR_KB_SHIFT) & GPT_TLBI_RPA_BADDR_MASK));
+		pa += 1UL << tlbi_shift[i];
+	}
+}
+
 /*
  * This function is the granule transition delegate service. When a granule
  * transition request occurs it is routed to this function to have the request,
  * if valid, fulfilled following A1.1.1 Delegate of RME supplement
  *
- * TODO: implement support for transitioning multiple granules at once.
- *
  * Parameters
  *   base		Base address of the region to transition, must be
  *			aligned to granule size.
  *   size		Size of region to transition, must be aligned to granule
- *			size.
+ *			size and no larger than GPT_MAX_TRANSITION_SIZE.
  *   src_sec_state	Security state of the caller.
  *
  * Return
@@ -1019,7 +1175,6 @@ static int get_gpi_params(uint64_t base, gpi_info_t *gpi_info)
  */
 int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 {
-	gpi_info_t gpi_info;
 	uint64_t nse;
 	int res;
 	unsigned int target_pas;
@@ -1034,28 +1189,9 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	assert(src_sec_state == SMC_FROM_REALM ||
 	       src_sec_state == SMC_FROM_SECURE);
 
-	/* See if this is a single or a range of granule transition. */
-	if (size != GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
-		return -EINVAL;
-	}
-
-	/* Check that base and size are valid */
-	if ((ULONG_MAX - base) < size) {
-		VERBOSE("[GPT] Transition request address overflow!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
-	}
-
-	/* Make sure base and size are valid. */
-	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    (size == 0UL) ||
-	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
-		VERBOSE("[GPT] Invalid granule transition address range!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
+	res = check_transition_range(base, size);
+	if (res != 0) {
+		return res;
 	}
 
 	target_pas = GPT_GPI_REALM;
@@ -1064,26 +1200,23 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	}
 
 	/*
-	 * Access to L1 tables is controlled by a global lock to ensure
-	 * that no more than one CPU is allowed to make changes at any
-	 * given time.
+	 * Access to the L1 descriptors of the range is controlled by the
+	 * locks covering it, to ensure that no more than one CPU is allowed
+	 * to change them at any given time.
 	 */
-	spin_lock(&gpt_lock);
-	res = get_gpi_params(base, &gpi_info);
+	gpt_lock_range(base, size);
+
+	/* Check that the whole range is in NS state */
+	res = check_gpi_range(base, size, GPT_GPI_NS);
 	if (res != 0) {
-		spin_unlock(&gpt_lock);
+		if (res == -EPERM) {
+			VERBOSE("[GPT] Only Granule in NS state can be delegated.\n");
+			VERBOSE("      Caller: %u\n", src_sec_state);
+		}
+		gpt_unlock_range(base, size);
 		return res;
 	}
 
-	/* Check that the current address is in NS state */
-	if (gpi_info.gpi != GPT_GPI_NS) {
-		VERBOSE("[GPT] Only Granule in NS state can be delegated.\n");
-		VERBOSE("      Caller: %u, Current GPI: %u\n", src_sec_state,
-			gpi_info.gpi);
-		spin_unlock(&gpt_lock);
-		return -EPERM;
-	}
-
 	if (src_sec_state == SMC_FROM_SECURE) {
 		nse = (uint64_t)GPT_NSE_SECURE << GPT_NSE_SHIFT;
 	} else {
@@ -1095,30 +1228,27 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 * states, remove any data speculatively fetched into the target
 	 * physical address space. Issue DC CIPAPA over address range
 	 */
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, target_pas);
+	write_gpi_range(base, size, target_pas);
 	dsboshst();
 
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_by_pa_range(base, size);
 	dsbosh();
 
 	nse = (uint64_t)GPT_NSE_NS << GPT_NSE_SHIFT;
 
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
 	/* Unlock access to the L1 tables. */
-	spin_unlock(&gpt_lock);
+	gpt_unlock_range(base, size);
 
 	/*
 	 * The isb() will be done as part of context
 	 * synchronization when returning to lower EL
 	 */
-	VERBOSE("[GPT] Granule 0x%" PRIx64 ", GPI 0x%x->0x%x\n",
-		base, gpi_info.gpi, target_pas);
+	VERBOSE("[GPT] Granules 0x%" PRIx64 "-0x%" PRIx64 ", GPI 0x%x->0x%x\n",
+		base, base + size - 1UL, GPT_GPI_NS, target_pas);
 
 	return 0;
 }
@@ -1128,13 +1258,11 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
- *
  * Parameters
  *   base		Base address of the region to transition, must be
  *			aligned to granule size.
  *   size		Size of region to transition, must be aligned to granule
- *			size.
+ *			size and no larger than GPT_MAX_TRANSITION_SIZE.
  *   src_sec_state	Security state of the caller.
  *
  * Return
@@ -1142,9 +1270,9 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
  */
 int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 {
-	gpi_info_t gpi_info;
 	uint64_t nse;
 	int res;
+	unsigned int current_pas;
 
 	/* Ensure that the tables have been set up before taking requests. */
 	assert(gpt_config.plat_gpt_l0_base != 0UL);
@@ -1156,66 +1284,43 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	assert(src_sec_state == SMC_FROM_REALM ||
 	       src_sec_state == SMC_FROM_SECURE);
 
-	/* See if this is a single or a range of granule transition. */
-	if (size != GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
-		return -EINVAL;
-	}
-
-	/* Check that base and size are valid */
-	if ((ULONG_MAX - base) < size) {
-		VERBOSE("[GPT] Transition request address overflow!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
+	res = check_transition_range(base, size);
+	if (res != 0) {
+		return res;
 	}
 
-	/* Make sure base and size are valid. */
-	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    (size == 0UL) ||
-	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
-		VERBOSE("[GPT] Invalid granule transition address range!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		VERBOSE("      Size=0x%lx\n", size);
-		return -EINVAL;
+	current_pas = GPT_GPI_REALM;
+	if (src_sec_state == SMC_FROM_SECURE) {
+		current_pas = GPT_GPI_SECURE;
 	}
 
 	/*
-	 * Access to L1 tables is controlled by a global lock to ensure
-	 * that no more than one CPU is allowed to make changes at any
-	 * given time.
+	 * Access to the L1 descriptors of the range is controlled by the
+	 * locks covering it, to ensure that no more than one CPU is allowed
+	 * to change them at any given time.
 	 */
-	spin_lock(&gpt_lock);
+	gpt_lock_range(base, size);
 
-	res = get_gpi_params(base, &gpi_info);
+	/* Check that the whole range is in the delegated state */
+	res = check_gpi_range(base, size, current_pas);
 	if (res != 0) {
-		spin_unlock(&gpt_lock);
+		if (res == -EPERM) {
+			VERBOSE("[GPT] Only Granule in REALM or SECURE state can be undelegated.\n");
+			VERBOSE("      Caller: %u\n", src_sec_state);
+		}
+		gpt_unlock_range(base, size);
 		return res;
 	}
 
-	/* Check that the current address is in the delegated state */
-	if ((src_sec_state == SMC_FROM_REALM  &&
-	     gpi_info.gpi != GPT_GPI_REALM) ||
-	    (src_sec_state == SMC_FROM_SECURE &&
-	     gpi_info.gpi != GPT_GPI_SECURE)) {
-		VERBOSE("[GPT] Only Granule in REALM or SECURE state can be undelegated.\n");
-		VERBOSE("      Caller: %u, Current GPI: %u\n", src_sec_state,
-			gpi_info.gpi);
-		spin_unlock(&gpt_lock);
-		return -EPERM;
-	}
-
-
 	/* In order to maintain mutual distrust between Realm and Secure
 	 * states, remove access now, in order to guarantee that writes
 	 * to the currently-accessible physical address space will not
 	 * later become observable.
 	 */
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, GPT_GPI_NO_ACCESS);
+	write_gpi_range(base, size, GPT_GPI_NO_ACCESS);
 	dsboshst();
 
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_by_pa_range(base, size);
 	dsbosh();
 
 	if (src_sec_state == SMC_FROM_SECURE) {
@@ -1225,8 +1330,7 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	}
 
 	/* Ensure that the scrubbed data has made it past the PoPA */
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
 	/*
 	 * Remove any data loaded speculatively
@@ -1234,27 +1338,25 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 */
 	nse = (uint64_t)GPT_NSE_NS << GPT_NSE_SHIFT;
 
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
-	/* Clear existing GPI encoding and transition granule. */
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, GPT_GPI_NS);
+	/* Clear existing GPI encoding and transition granules. */
+	write_gpi_range(base, size, GPT_GPI_NS);
 	dsboshst();
 
 	/* Ensure that all agents observe the new NS configuration */
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_by_pa_range(base, size);
 	dsbosh();
 
 	/* Unlock access to the L1 tables. */
-	spin_unlock(&gpt_lock);
+	gpt_unlock_range(base, size);
 
 	/*
 	 * The isb() will be done as part of context
 	 * synchronization when returning to lower EL
 	 */
-	VERBOSE("[GPT] Granule 0x%" PRIx64 ", GPI 0x%x->0x%x\n",
-		base, gpi_info.gpi, GPT_GPI_NS);
+	VERBOSE("[GPT] Granules 0x%" PRIx64 "-0x%" PRIx64 ", GPI 0x%x->0x%x\n",
+		base, base + size - 1UL, current_pas, GPT_GPI_NS);
 
 	return 0;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2023, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -53,6 +53,16 @@
 					 ((uint64_t)(_gpi) << 4*14) | \
 					 ((uint64_t)(_gpi) << 4*15))
 
+/* Number of GPI fields in an L1 granules descriptor. */
+#define GPT_L1_GPI_COUNT		U(16)
+
+/* Number of locks protecting the L1 descriptors, must be a power of 2. */
+#define GPT_LOCK_COUNT			U(32)
+
+/* TLBI RPALOS/RPAOS operand fields. */
+#define GPT_TLBI_RPA_SIZE_SHIFT		U(44)
+#define GPT_TLBI_RPA_BADDR_MASK		UL(0xFFFFFFFFFF)
+
 /******************************************************************************/
 /* GPT platform configuration                                                 */
 /******************************************************************************/
@@ -106,17 +116,6 @@ typedef enum {
 	PGS_64KB_P =	16U
 } gpt_p_val_e;
 
-/*
- * Internal structure to retrieve the values from get_gpi_info();
- */
-typedef struct gpi_info {
-	uint64_t gpt_l1_desc;
-	uint64_t *gpt_l1_addr;
-	unsigned int idx;
-	unsigned int gpi_shift;
-	unsigned int gpi;
-} gpi_info_t;
-
 /* Max valid value for PGS. */
 #define GPT_PGS_MAX			(2U)
 
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2020-2021, Arm Limited. All rights reserved.
+# Copyright (c) 2020-2023, Arm Limited. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -10,8 +10,6 @@ LIBC_SRCS	:=	$(addprefix lib/libc/,		\
 			exit.c				\
 			memchr.c			\
 			memcmp.c			\
-			memcpy.c			\
-			memmove.c			\
 			memrchr.c			\
 			printf.c			\
 			putchar.c			\
@@ -33,10 +31,14 @@ LIBC_SRCS	:=	$(addprefix lib/libc/,		\
 
 ifeq (${ARCH},aarch64)
 LIBC_SRCS	+=	$(addprefix lib/libc/aarch64/,	\
+			memcpy.S			\
+			memmove.S			\
 			memset.S			\
 			setjmp.S)
 else
 LIBC_SRCS	+=	$(addprefix lib/libc/aarch32/,	\
+			memcpy.S			\
+			memmove.S			\
 			memset.S)
 endif
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2018, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -49,6 +49,8 @@ static int pmf_svc_descs_indices[PMF_SVC_DESCS_MAX];
  */
 static int pmf_num_services;
 
+static pmf_svc_desc_t *get_service(unsigned int tid);
+
 /*
  * This is the main PMF function that initialize registered
  * PMF services and also sort them in ascending order.
@@ -57,6 +59,7 @@ int pmf_setup(void)
 {
 	int rc, ii, jj = 0;
 	int pmf_svc_descs_num, temp_val;
+	const pmf_svc_desc_t *cur, *next;
 
 	/* If no PMF services are registered then simply bail out */
 	pmf_svc_descs_num = (PMF_SVC_DESCS_END - PMF_SVC_DESCS_START)/
@@ -97,9 +100,10 @@ int pmf_setup(void)
 	 */
 	for (ii = 1; ii < pmf_num_services; ii++) {
 		for (jj = 0; jj < (pmf_num_services - ii); jj++) {
-			if ((pmf_svc_descs[jj].svc_config & PMF_SVC_ID_MASK) >
-				(pmf_svc_descs[jj + 1].svc_config &
-						PMF_SVC_ID_MASK)) {
+			cur = &pmf_svc_descs[pmf_svc_descs_indices[jj]];
+			next = &pmf_svc_descs[pmf_svc_descs_indices[jj + 1]];
+			if ((cur->svc_config & PMF_SVC_ID_MASK) >
+				(next->svc_config & PMF_SVC_ID_MASK)) {
 				temp_val = pmf_svc_descs_indices[jj];
 				pmf_svc_descs_indices[jj] =
 						pmf_svc_descs_indices[jj+1];
@@ -108,6 +112,17 @@ int pmf_setup(void)
 		}
 	}
 
+	/* Make sure every registered service can be looked up */
+	for (ii = 0; ii < pmf_num_services; ii++) {
+		jj = pmf_svc_descs_indices[ii];
+		if (get_service(pmf_svc_descs[jj].svc_config &
+				PMF_SVC_ID_MASK) != &pmf_svc_descs[jj]) {
+			ERROR("PMF service %s cannot be looked up\n",
+				pmf_svc_descs[jj].name);
+			panic();
+		}
+	}
+
 	return 0;
 }
 
@@ -119,7 +134,7 @@ static pmf_svc_desc_t *get_service(unsigned int tid)
 {
 	int low = 0;
 	int mid;
-	int high = pmf_num_services;
+	int high = pmf_num_services - 1;
 	unsigned int svc_id = tid & PMF_SVC_ID_MASK;
 	int index;
 	unsigned int desc_svc_id;
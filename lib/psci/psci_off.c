@@ -11,6 +11,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
+#include <drivers/console.h>
 #include <lib/pmf/pmf.h>
 #include <lib/runtime_instr.h>
 #include <plat/common/platform.h>
@@ -70,6 +71,9 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 		}
 	}
 
+	/* Write out what this CPU printed before its caches are turned off */
+	console_drain();
+
 	/*
 	 * Get the parent nodes here, this is important to do before we
 	 * initiate the power down sequence as after that point the core may
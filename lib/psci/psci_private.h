@@ -16,6 +16,7 @@
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/psci/psci.h>
 #include <lib/spinlock.h>
+#include <lib/ticket_lock.h>
 
 /*
  * The PSCI capability which are provided by the generic code but does not
@@ -179,9 +180,14 @@ typedef enum suspend_mode {
 #if HW_ASSISTED_COHERENCY
 /*
  * On systems where participant CPUs are cache-coherent, we can use spinlocks
- * instead of bakery locks.
+ * instead of bakery locks. Ticket locks can be selected instead so that the
+ * locks are granted in order when many CPUs contend for them.
  */
+#if PSCI_USE_TICKET_LOCK
+#define DEFINE_PSCI_LOCK(_name)		ticket_lock_t _name
+#else
 #define DEFINE_PSCI_LOCK(_name)		spinlock_t _name
+#endif
 #define DECLARE_PSCI_LOCK(_name)	extern DEFINE_PSCI_LOCK(_name)
 
 /* One lock is required per non-CPU power domain node */
@@ -206,6 +212,17 @@ static inline void psci_dsbish(void)
 	/* Empty */
 }
 
+#if PSCI_USE_TICKET_LOCK
+static inline void psci_lock_get(non_cpu_pd_node_t *non_cpu_pd_node)
+{
+	ticket_lock(&psci_locks[non_cpu_pd_node->lock_index]);
+}
+
+static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
+{
+	ticket_unlock(&psci_locks[non_cpu_pd_node->lock_index]);
+}
+#else
 static inline void psci_lock_get(non_cpu_pd_node_t *non_cpu_pd_node)
 {
 	spin_lock(&psci_locks[non_cpu_pd_node->lock_index]);
@@ -215,6 +232,7 @@ static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
 {
 	spin_unlock(&psci_locks[non_cpu_pd_node->lock_index]);
 }
+#endif /* PSCI_USE_TICKET_LOCK */
 
 #else /* if HW_ASSISTED_COHERENCY == 0 */
 /*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2019, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,10 +13,6 @@
 
 #include "psci_private.h"
 
-#ifndef PLAT_MAX_PWR_LVL_STATES
-#define PLAT_MAX_PWR_LVL_STATES		2U
-#endif
-
 /* Following structure is used for PSCI STAT */
 typedef struct psci_stat {
 	u_register_t residency;
@@ -32,10 +28,12 @@ static int last_cpu_in_non_cpu_pd[PSCI_NUM_NON_CPU_PWR_DOMAINS] = {
 
 /*
  * Following are used to store PSCI STAT values for
- * CPU and non CPU power domains.
+ * CPU and non CPU power domains. The statistics of a CPU are only updated by
+ * that CPU, so each CPU gets its own cache line to avoid false sharing.
  */
-static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
-				[PLAT_MAX_PWR_LVL_STATES];
+static struct {
+	psci_stat_t stat[PLAT_MAX_PWR_LVL_STATES];
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_cpu_stat[PLATFORM_CORE_COUNT];
 static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
 				[PLAT_MAX_PWR_LVL_STATES];
 
@@ -127,8 +125,8 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	    state_info, cpu_idx);
 
 	/* Update CPU stats. */
-	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
-	psci_cpu_stat[cpu_idx][stat_idx].count++;
+	psci_cpu_stat[cpu_idx].stat[stat_idx].residency += residency;
+	psci_cpu_stat[cpu_idx].stat[stat_idx].count++;
 
 	/*
 	 * Check what power domains above CPU were off
@@ -217,7 +215,7 @@ static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 		*psci_stat = psci_non_cpu_stat[parent_idx][stat_idx];
 	} else {
 		/* Get the cpu power domain stats */
-		*psci_stat = psci_cpu_stat[target_idx][stat_idx];
+		*psci_stat = psci_cpu_stat[target_idx].stat[stat_idx];
 	}
 
 	return PSCI_E_SUCCESS;
@@ -248,3 +246,43 @@ u_register_t psci_stat_count(u_register_t target_cpu,
 	else
 		return 0;
 }
+
+/*******************************************************************************
+ * This function takes a snapshot of the statistics of all the CPU and non CPU
+ * power domains, for instance to expose them through debugfs.
+ ******************************************************************************/
+void psci_stat_dump(psci_stat_dump_t *dump)
+{
+	const non_cpu_pd_node_t *node;
+	unsigned int i, j;
+
+	assert(dump != NULL);
+
+	dump->version = PSCI_STAT_DUMP_VERSION;
+	dump->cpu_count = PLATFORM_CORE_COUNT;
+	dump->non_cpu_count = PSCI_NUM_NON_CPU_PWR_DOMAINS;
+	dump->state_count = PLAT_MAX_PWR_LVL_STATES;
+
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++) {
+		for (j = 0U; j < PLAT_MAX_PWR_LVL_STATES; j++) {
+			dump->cpu[i][j].residency =
+				psci_cpu_stat[i].stat[j].residency;
+			dump->cpu[i][j].count = psci_cpu_stat[i].stat[j].count;
+		}
+	}
+
+	for (i = 0U; i < PSCI_NUM_NON_CPU_PWR_DOMAINS; i++) {
+		node = &psci_non_cpu_pd_nodes[i];
+		dump->non_cpu[i].level = node->level;
+		dump->non_cpu[i].parent_node = node->parent_node;
+		dump->non_cpu[i].cpu_start_idx = node->cpu_start_idx;
+		dump->non_cpu[i].ncpus = node->ncpus;
+
+		for (j = 0U; j < PLAT_MAX_PWR_LVL_STATES; j++) {
+			dump->non_cpu[i].stat[j].residency =
+				psci_non_cpu_stat[i][j].residency;
+			dump->non_cpu[i].stat[j].count =
+				psci_non_cpu_stat[i][j].count;
+		}
+	}
+}
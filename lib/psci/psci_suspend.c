@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -12,6 +12,7 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <context.h>
+#include <drivers/console.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/el3_runtime/cpu_data.h>
 #include <lib/el3_runtime/pubsub_events.h>
@@ -141,6 +142,56 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
 #endif
 }
 
+/*******************************************************************************
+ * This function returns true if a suspend request to 'end_pwrlvl' can take the
+ * CPU level fast path. Such a request does not change the state of any parent
+ * power domain in platform-coordinated mode, so it does not need to take the
+ * power domain locks nor to coordinate with other CPUs. In OS-initiated mode,
+ * the request must still be validated against the states of the other CPUs.
+ ******************************************************************************/
+static bool psci_is_cpu_suspend_fast_path(unsigned int end_pwrlvl)
+{
+#if PSCI_OS_INIT_MODE
+	if (psci_suspend_mode == OS_INIT) {
+		return false;
+	}
+#endif
+	return end_pwrlvl == PSCI_CPU_PWR_LVL;
+}
+
+/*******************************************************************************
+ * CPU level fast path of psci_cpu_suspend_start(). It only updates the state of
+ * the calling CPU and returns false if the suspend has been abandoned because
+ * of a pending interrupt.
+ ******************************************************************************/
+static bool psci_cpu_suspend_fast_start(const entry_point_info_t *ep,
+					psci_power_state_t *state_info,
+					unsigned int is_power_down_state)
+{
+	if (read_isr_el1() != 0U) {
+		return false;
+	}
+
+	psci_set_cpu_local_state(state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]);
+
+	/*
+	 * Need to flush as local_state might be accessed with Data Cache
+	 * disabled during power on
+	 */
+	psci_flush_cpu_data(psci_svc_cpu_data.local_state);
+
+	if (is_power_down_state != 0U)
+		psci_suspend_to_pwrdown_start(PSCI_CPU_PWR_LVL, ep, state_info);
+
+	psci_plat_pm_ops->pwr_domain_suspend(state_info);
+
+#if ENABLE_PSCI_STAT
+	plat_psci_stat_accounting_start(state_info);
+#endif
+
+	return true;
+}
+
 /*******************************************************************************
  * Top level handler which is called when a cpu wants to suspend its execution.
  * It is assumed that along with suspending the cpu power domain, power domains
@@ -176,6 +227,22 @@ int psci_cpu_suspend_start(const entry_point_info_t *ep,
 	assert((psci_plat_pm_ops->pwr_domain_suspend != NULL) &&
 	       (psci_plat_pm_ops->pwr_domain_suspend_finish != NULL));
 
+	/* Write out what this CPU printed before it goes idle */
+	console_drain();
+
+	if (is_power_down_state != 0U) {
+		PUBLISH_EVENT(psci_suspend_pwrdown_prepare);
+	}
+
+	if (psci_is_cpu_suspend_fast_path(end_pwrlvl)) {
+		if (!psci_cpu_suspend_fast_start(ep, state_info,
+						 is_power_down_state)) {
+			return rc;
+		}
+
+		goto enter_wfi;
+	}
+
 	/* Get the parent nodes */
 	psci_get_parent_pwr_domain_nodes(idx, end_pwrlvl, parent_nodes);
 
@@ -264,6 +331,7 @@ exit:
 		return rc;
 	}
 
+enter_wfi:
 	if (is_power_down_state != 0U) {
 #if ENABLE_RUNTIME_INSTRUMENTATION
 
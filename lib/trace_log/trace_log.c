@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdarg.h>
+
+#include <arch_helpers.h>
+#include <lib/cassert.h>
+#include <lib/trace_log/trace_log.h>
+#include <plat/common/platform.h>
+
+CASSERT(IS_POWER_OF_TWO(PLAT_TRACE_LOG_ENTRIES),
+	assert_trace_log_entries_power_of_two);
+
+/* Trace buffer, read by the host decoder */
+trace_log_buffer_t trace_log_buffer;
+
+/* Number of events recorded by each CPU, only updated by that CPU */
+static struct {
+	uint32_t count;
+} __aligned(CACHE_WRITEBACK_GRANULE) trace_log_cpu[PLATFORM_CORE_COUNT];
+
+void trace_log_init(void)
+{
+	trace_log_header_t *header = &trace_log_buffer.header;
+
+	header->version = TRACE_LOG_VERSION;
+	header->cpu_count = PLATFORM_CORE_COUNT;
+	header->entries_per_cpu = PLAT_TRACE_LOG_ENTRIES;
+	header->entry_size = (uint32_t)sizeof(trace_log_entry_t);
+	header->max_args = TRACE_LOG_MAX_ARGS;
+
+	/* Let readers know that the header is valid */
+	dmbish();
+	header->magic = TRACE_LOG_MAGIC;
+}
+
+/*
+ * Record an event in the ring of the calling CPU. This does not need a lock
+ * as each ring is only written by its CPU. A reader on another CPU may see an
+ * event being written, in which case its sequence number is 0.
+ */
+void trace_log_record(uintptr_t fmt_id, unsigned int nargs, ...)
+{
+	unsigned int cpu = plat_my_core_pos();
+	uint32_t seq = ++trace_log_cpu[cpu].count;
+	trace_log_entry_t *entry;
+	va_list args;
+	unsigned int i;
+
+	assert(nargs <= TRACE_LOG_MAX_ARGS);
+
+	entry = &trace_log_buffer.entries[cpu]
+					 [(seq - 1U) & (PLAT_TRACE_LOG_ENTRIES - 1U)];
+
+	entry->seq = 0U;
+	dmbishst();
+
+	entry->timestamp = read_cntpct_el0();
+	entry->fmt_id = fmt_id;
+	entry->nargs = nargs;
+
+	va_start(args, nargs);
+	for (i = 0U; i < nargs; i++) {
+		entry->args[i] = va_arg(args, u_register_t);
+	}
+	va_end(args);
+
+	dmbishst();
+	entry->seq = seq;
+}
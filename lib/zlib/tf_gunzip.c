@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2023, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -102,14 +102,22 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	return ret;
 }
 
-/* Wrapper function to calculate CRC
+/*
+ * zlib's CRC-32 entry point, used by inflate() to check gzip streams. It is
+ * routed to tf_crc32() so that a single CRC engine serves the whole image
+ * and zlib's own CRC tables are not linked in.
  * @crc: previous accumulated CRC
- * @buf: buffer base address
- * @size: size of the buffer
+ * @buf: buffer base address, or Z_NULL to get the initial CRC value
+ * @len: size of the buffer
  *
  * Return calculated CRC32 value
  */
-uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size)
+unsigned long ZEXPORT crc32(unsigned long crc, const unsigned char *buf,
+			    unsigned int len)
 {
-	return (uint32_t)crc32((unsigned long)crc, buf, size);
+	if (buf == Z_NULL) {
+		return 0UL;
+	}
+
+	return (unsigned long)tf_crc32((uint32_t)crc, buf, len);
 }
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2018, Arm Limited and Contributors. All rights reserved.
+# Copyright (c) 2018-2023, Arm Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -7,9 +7,10 @@
 ZLIB_PATH	:=	lib/zlib
 
 # Imported from zlib 1.2.11 (do not modify them)
+# crc32.c is not built: crc32() is provided by tf_gunzip.c on top of
+# tf_crc32().
 ZLIB_SOURCES	:=	$(addprefix $(ZLIB_PATH)/,	\
 					adler32.c	\
-					crc32.c		\
 					inffast.c	\
 					inflate.c	\
 					inftrees.c	\
@@ -19,6 +20,9 @@ ZLIB_SOURCES	:=	$(addprefix $(ZLIB_PATH)/,	\
 ZLIB_SOURCES	+=	$(addprefix $(ZLIB_PATH)/,	\
 					tf_gunzip.c)
 
+# CRC-32 engine behind crc32()
+ZLIB_SOURCES	+=	common/tf_crc32.c
+
 INCLUDES	+=	-Iinclude/lib/zlib
 
 # REVISIT: the following flags need not be given globally
@@ -26,6 +26,10 @@ ARM_ARCH_FEATURE		:= none
 ARM_ARCH_MAJOR			:= 8
 ARM_ARCH_MINOR			:= 0
 
+# Hand the certificate signatures verified by BL1 over to BL2, which does not
+# check them again.
+AUTH_CERT_CACHE			:= 0
+
 # Base commit to perform code check on
 BASE_COMMIT			:= origin/master
 
@@ -93,6 +97,10 @@ DISABLE_MTPMU			:= 0
 # development platforms.
 DYN_DISABLE_AUTH		:= 0
 
+# Buffer the runtime console output of BL31 per CPU, and write it out when the
+# CPU goes idle rather than while printing.
+ENABLE_CONSOLE_BUFFER		:= 0
+
 # Build option to enable MPAM for lower ELs
 ENABLE_MPAM_FOR_LOWER_ELS	:= 0
 
@@ -114,12 +122,18 @@ ENABLE_PSCI_STAT		:= 0
 # Flag to enable Realm Management Extension (FEAT_RME)
 ENABLE_RME			:= 0
 
+# Flag to enable per runtime service SMC statistics using PMF
+ENABLE_RT_SVC_STATS		:= 0
+
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
 # Flag to enable stack corruption protection
 ENABLE_STACK_PROTECTOR		:= 0
 
+# Flag to enable the binary trace log of BL31
+ENABLE_TRACE_LOG		:= 0
+
 # Flag to enable exception handling in EL3
 EL3_EXCEPTION_HANDLING		:= 0
 
@@ -242,6 +256,10 @@ HANDLE_EA_EL3_FIRST_NS		:= 0
 # The default value is sha256.
 HASH_ALG			:= sha256
 
+# Hash images with HASH_ALG while they are read, so that verifying or measuring
+# them does not need another pass over the data.
+HASH_IMAGE_ON_LOAD		:= 0
+
 # Whether system coherency is managed in hardware, without explicit software
 # operations.
 HW_ASSISTED_COHERENCY		:= 0
@@ -420,6 +438,11 @@ SANITIZE_UB := off
 # Default: disabled
 USE_SPINLOCK_CAS := 0
 
+# Use ticket locks rather than spinlocks for the PSCI power domain locks. Only
+# applicable when HW_ASSISTED_COHERENCY is enabled.
+# Default: disabled
+PSCI_USE_TICKET_LOCK := 0
+
 # Enable Link Time Optimization
 ENABLE_LTO			:= 0
 
@@ -429,6 +452,10 @@ ENABLE_LTO			:= 0
 # CTX_INCLUDE_EL2_REGS.
 CTX_INCLUDE_EL2_REGS		:= 0
 
+# Skip writing the EL2 register groups whose value does not change on a world
+# switch. Only applicable when CTX_INCLUDE_EL2_REGS is enabled.
+CTX_EL2_SKIP_UNCHANGED_REGS	:= 0
+
 # Enable Memory tag extension which is supported for architecture greater
 # than Armv8.5-A
 # By default it is set to "no"
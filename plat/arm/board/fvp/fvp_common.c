@@ -469,6 +469,13 @@ int plat_get_mbedtls_heap(void **heap_addr, size_t *heap_size)
 }
 #endif /* CRYPTO_SUPPORT */
 
+#if AUTH_CERT_CACHE && defined(IMAGE_BL2)
+int plat_get_auth_cert_cache(void **cache_addr, size_t *cache_size)
+{
+	return arm_get_auth_cert_cache(cache_addr, cache_size);
+}
+#endif /* AUTH_CERT_CACHE && defined(IMAGE_BL2) */
+
 void fvp_timer_init(void)
 {
 #if USE_SP804_TIMER
@@ -208,6 +208,11 @@ void arm_bl1_platform_setup(void)
 	arm_bl1_set_mbedtls_heap();
 #endif /* CRYPTO_SUPPORT */
 
+#if AUTH_CERT_CACHE
+	/* Share the certificates verified by BL1 with BL2 */
+	arm_bl1_set_auth_cert_cache();
+#endif /* AUTH_CERT_CACHE */
+
 	/*
 	 * Allow access to the System counter timer module and program
 	 * counter frequency for non secure images during FWU
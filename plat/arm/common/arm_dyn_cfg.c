@@ -15,6 +15,7 @@
 #include <common/debug.h>
 #include <common/desc_image_load.h>
 #include <common/tbbr/tbbr_img_def.h>
+#include <drivers/auth/auth_mod.h>
 #include <lib/fconf/fconf.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
 #include <lib/fconf/fconf_tbbr_getter.h>
@@ -120,6 +121,57 @@ void arm_bl1_set_mbedtls_heap(void)
 }
 #endif /* CRYPTO_SUPPORT */
 
+#if AUTH_CERT_CACHE
+/*
+ * Hand the certificates verified by BL1 over to BL2. The cache is written by
+ * BL1 as it verifies certificates, only its address is put in the DTB here.
+ * This is optional, BL2 verifies all the certificates again if the DTB has no
+ * placeholder for the cache.
+ */
+void arm_bl1_set_auth_cert_cache(void)
+{
+	const struct dyn_cfg_dtb_info_t *tb_fw_config_info;
+	uintptr_t tb_fw_cfg_dtb;
+	void *cache_addr;
+	size_t cache_size;
+	void *dtb;
+
+	tb_fw_config_info = FCONF_GET_PROPERTY(dyn_cfg, dtb, TB_FW_CONFIG_ID);
+	assert(tb_fw_config_info != NULL);
+
+	tb_fw_cfg_dtb = tb_fw_config_info->config_addr;
+	if (tb_fw_cfg_dtb == 0UL) {
+		return;
+	}
+
+	/* As libfdt uses void *, we can't avoid this cast */
+	dtb = (void *)tb_fw_cfg_dtb;
+
+	auth_mod_get_cert_cache(&cache_addr, &cache_size);
+	if (arm_set_dtb_auth_cert_cache_info(dtb, cache_addr,
+					     cache_size) != 0) {
+		VERBOSE("BL1: verified certificates not shared with BL2\n");
+		return;
+	}
+
+	flush_dcache_range(tb_fw_cfg_dtb, fdt_totalsize(dtb));
+}
+
+/* Retrieve the certificates verified by BL1, in BL2 */
+int arm_get_auth_cert_cache(void **cache_addr, size_t *cache_size)
+{
+	assert(cache_addr != NULL);
+	assert(cache_size != NULL);
+
+	*cache_addr = FCONF_GET_PROPERTY(tbbr, dyn_config,
+					 auth_cert_cache_addr);
+	*cache_size = FCONF_GET_PROPERTY(tbbr, dyn_config,
+					 auth_cert_cache_size);
+
+	return (*cache_addr != NULL) ? 0 : -1;
+}
+#endif /* AUTH_CERT_CACHE */
+
 /*
  * BL2 utility function to initialize dynamic configuration specified by
  * FW_CONFIG. Populate the bl_mem_params_node_t of other FW_CONFIGs if
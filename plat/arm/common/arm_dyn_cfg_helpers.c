@@ -21,6 +21,8 @@
 
 #define DTB_PROP_MBEDTLS_HEAP_ADDR "mbedtls_heap_addr"
 #define DTB_PROP_MBEDTLS_HEAP_SIZE "mbedtls_heap_size"
+#define DTB_PROP_AUTH_CERT_CACHE_ADDR "auth_cert_cache_addr"
+#define DTB_PROP_AUTH_CERT_CACHE_SIZE "auth_cert_cache_size"
 
 #if MEASURED_BOOT
 #ifdef SPD_opteed
@@ -123,6 +125,46 @@ int arm_set_dtb_mbedtls_heap_info(void *dtb, void *heap_addr, size_t heap_size)
 	return 0;
 }
 
+/*
+ * This function writes the address and size of the cache of verified
+ * certificates in the DTB, if it has placeholders for them. It is supposed to
+ * be called only by BL1.
+ *
+ * Returns:
+ *	0 = success
+ *     -1 = error
+ */
+int arm_set_dtb_auth_cert_cache_info(void *dtb, void *cache_addr,
+				     size_t cache_size)
+{
+	int dtb_root;
+	int err;
+
+	err = arm_dyn_tb_fw_cfg_init(dtb, &dtb_root);
+	if (err < 0) {
+		return -1;
+	}
+
+	/*
+	 * NOTE: The variables cache_addr and cache_size are corrupted
+	 * by the "fdtw_write_inplace_cells" function. After the
+	 * function calls they must NOT be reused.
+	 */
+	err = fdtw_write_inplace_cells(dtb, dtb_root,
+		DTB_PROP_AUTH_CERT_CACHE_ADDR, 2, &cache_addr);
+	if (err < 0) {
+		return -1;
+	}
+
+	err = fdtw_write_inplace_cells(dtb, dtb_root,
+		DTB_PROP_AUTH_CERT_CACHE_SIZE, 1, &cache_size);
+	if (err < 0) {
+		return -1;
+	}
+
+	return 0;
+}
+
 #if MEASURED_BOOT
 /*
  * Write the Event Log address and its size in the DTB.
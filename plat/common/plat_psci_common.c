@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2023, ARM Limited and Contributors. All rights reserved.
  * Copyright (c) 2020, NVIDIA Corporation. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -30,6 +30,17 @@
 #define PSCI_STAT_ID_EXIT_LOW_PWR		1
 #define PSCI_STAT_TOTAL_IDS			2
 
+/*
+ * With hardware assisted coherency, CPUs stay coherent with their data cache
+ * enabled until they are powered down, so the timestamps captured on the
+ * power down path need no cache maintenance.
+ */
+#if HW_ASSISTED_COHERENCY
+#define PSCI_STAT_PMF_FLAGS			PMF_NO_CACHE_MAINT
+#else
+#define PSCI_STAT_PMF_FLAGS			PMF_CACHE_MAINT
+#endif
+
 PMF_DECLARE_CAPTURE_TIMESTAMP(psci_svc)
 PMF_DECLARE_GET_TIMESTAMP(psci_svc)
 PMF_REGISTER_SERVICE(psci_svc, PMF_PSCI_STAT_SVC_ID, PSCI_STAT_TOTAL_IDS,
@@ -70,7 +81,7 @@ void plat_psci_stat_accounting_start(
 {
 	assert(state_info != NULL);
 	PMF_CAPTURE_TIMESTAMP(psci_svc, PSCI_STAT_ID_ENTER_LOW_PWR,
-		PMF_CACHE_MAINT);
+		PSCI_STAT_PMF_FLAGS);
 }
 
 /*
@@ -82,7 +93,7 @@ void plat_psci_stat_accounting_stop(
 {
 	assert(state_info != NULL);
 	PMF_CAPTURE_TIMESTAMP(psci_svc, PSCI_STAT_ID_EXIT_LOW_PWR,
-		PMF_CACHE_MAINT);
+		PSCI_STAT_PMF_FLAGS);
 }
 
 /*
@@ -107,11 +118,11 @@ u_register_t plat_psci_stat_get_residency(unsigned int lvl,
 	/*
 	 * If power down is requested, then timestamp capture will
 	 * be with caches OFF.  Hence we have to do cache maintenance
-	 * when reading the timestamp.
+	 * when reading the timestamp, unless the CPUs are coherent.
 	 */
 	state = state_info->pwr_domain_state[PSCI_CPU_PWR_LVL];
 	if (is_local_state_off(state) != 0) {
-		pmf_flags = PMF_CACHE_MAINT;
+		pmf_flags = PSCI_STAT_PMF_FLAGS;
 	} else {
 		assert(is_local_state_retn(state) == 1);
 		pmf_flags = PMF_NO_CACHE_MAINT;
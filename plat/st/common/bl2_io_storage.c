@@ -58,6 +58,13 @@ static struct mmc_device_info mmc_info;
 
 static uint32_t block_buffer[MMC_BLOCK_SIZE] __aligned(MMC_BLOCK_SIZE);
 
+/*
+ * Largest read straight into an image. stm32_sdmmc2_read() gives a whole
+ * transfer 1s, and a 1-bit bus at 25MHz moves about 3MB/s, so keep each
+ * transfer to 1MB.
+ */
+#define MMC_MAX_XFER_SIZE	SZ_1M
+
 static io_block_dev_spec_t mmc_block_dev_spec = {
 	/* It's used as temp buffer in block driver */
 	.buffer = {
@@ -69,6 +76,7 @@ static io_block_dev_spec_t mmc_block_dev_spec = {
 		.write = NULL,
 	},
 	.block_size = MMC_BLOCK_SIZE,
+	.max_xfer_size = MMC_MAX_XFER_SIZE,
 };
 
 static const io_dev_connector_t *mmc_dev_con;
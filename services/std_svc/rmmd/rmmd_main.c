@@ -404,6 +404,20 @@ static int gpt_to_gts_error(int error, uint32_t smc_fid, uint64_t address)
 	return ret;
 }
 
+/*
+ * Return the size of the part of a GTSI range request to be transitioned by
+ * the current call. It stops at the next GPT_MAX_TRANSITION_SIZE boundary so
+ * that the work done per SMC is bounded and that the follow-up calls of a
+ * large request operate on aligned blocks.
+ */
+static uint64_t gtsi_range_chunk(uint64_t base, uint64_t size)
+{
+	uint64_t limit = GPT_MAX_TRANSITION_SIZE -
+			 (base & (GPT_MAX_TRANSITION_SIZE - 1UL));
+
+	return (size < limit) ? size : limit;
+}
+
 /*******************************************************************************
  * This function handles RMM-EL3 interface SMCs
  ******************************************************************************/
@@ -435,6 +449,16 @@ uint64_t rmmd_rmm_el3_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 	case RMM_GTSI_UNDELEGATE:
 		ret = gpt_undelegate_pas(x1, PAGE_SIZE_4KB, SMC_FROM_REALM);
 		SMC_RET1(handle, gpt_to_gts_error(ret, smc_fid, x1));
+	case RMM_GTSI_DELEGATE_RANGE:
+		x2 = gtsi_range_chunk(x1, x2);
+		ret = gpt_delegate_pas(x1, x2, SMC_FROM_REALM);
+		SMC_RET2(handle, gpt_to_gts_error(ret, smc_fid, x1),
+			 (ret == 0) ? x2 : 0UL);
+	case RMM_GTSI_UNDELEGATE_RANGE:
+		x2 = gtsi_range_chunk(x1, x2);
+		ret = gpt_undelegate_pas(x1, x2, SMC_FROM_REALM);
+		SMC_RET2(handle, gpt_to_gts_error(ret, smc_fid, x1),
+			 (ret == 0) ? x2 : 0UL);
 	case RMM_ATTEST_GET_PLAT_TOKEN:
 		ret = rmmd_attest_get_platform_token(x1, &x2, x3);
 		SMC_RET2(handle, ret, x2);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -181,6 +181,14 @@ struct secure_partition_desc {
 	 * management transactions if it is using FF-A v1.0.
 	 */
 	bool ns_bit_requested;
+
+	/*
+	 * Number of direct requests forwarded to and direct responses sent by
+	 * this SP, indexed by physical CPU. A S-EL0 SP has a single execution
+	 * context, so these cannot live in it.
+	 */
+	uint64_t dir_req_count[PLATFORM_CORE_COUNT];
+	uint64_t dir_resp_count[PLATFORM_CORE_COUNT];
 };
 
 /*
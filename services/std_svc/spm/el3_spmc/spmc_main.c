@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,6 +16,7 @@
 #include <common/runtime_svc.h>
 #include <common/uuid.h>
 #include <lib/el3_runtime/context_mgmt.h>
+#include <lib/pmf/pmf.h>
 #include <lib/smccc.h>
 #include <lib/utils.h>
 #include <lib/xlat_tables/xlat_tables_v2.h>
@@ -47,6 +48,22 @@ static struct secure_partition_desc sp_desc[SECURE_PARTITION_COUNT];
  */
 static struct ns_endpoint_desc ns_ep_desc[NS_PARTITION_COUNT];
 
+/* Descriptor of an SP or of an EL3 Logical Partition. */
+struct partition_entry {
+	uint16_t id;
+	struct secure_partition_desc *sp;
+	struct el3_lp_desc *lp;
+};
+
+/*
+ * Partitions managed by the SPMC sorted by ID, so that the destination of a
+ * direct message is found with a single binary search rather than by walking
+ * the descriptors of each kind of partition. It is built once all partitions
+ * have been set up and is not modified afterwards.
+ */
+static struct partition_entry partition_table[MAX_SP_LP_PARTITIONS];
+static unsigned int partition_table_count;
+
 static uint64_t spmc_sp_interrupt_handler(uint32_t id,
 					  uint32_t flags,
 					  void *handle,
@@ -92,6 +109,65 @@ struct secure_partition_desc *spmc_get_sp_ctx(uint16_t id)
 	return NULL;
 }
 
+/* Add a partition to the partition table, keeping it sorted by ID. */
+static void partition_table_add(uint16_t id, struct secure_partition_desc *sp,
+				struct el3_lp_desc *lp)
+{
+	unsigned int i = partition_table_count;
+
+	assert(i < ARRAY_SIZE(partition_table));
+
+	while ((i > 0U) && (partition_table[i - 1U].id > id)) {
+		partition_table[i] = partition_table[i - 1U];
+		i--;
+	}
+
+	partition_table[i].id = id;
+	partition_table[i].sp = sp;
+	partition_table[i].lp = lp;
+	partition_table_count++;
+}
+
+static void partition_table_init(void)
+{
+	struct el3_lp_desc *el3_lp_descs = get_el3_lp_array();
+
+	for (unsigned int i = 0U; i < SECURE_PARTITION_COUNT; i++) {
+		if (sp_desc[i].sp_id != INV_SP_ID) {
+			partition_table_add(sp_desc[i].sp_id, &sp_desc[i],
+					    NULL);
+		}
+	}
+
+	for (unsigned int i = 0U; i < EL3_LP_DESCS_COUNT; i++) {
+		partition_table_add(el3_lp_descs[i].sp_id, NULL,
+				    &el3_lp_descs[i]);
+	}
+}
+
+/* Helper function to get the SP or EL3 Logical Partition with a given ID. */
+static const struct partition_entry *partition_table_lookup(uint16_t id)
+{
+	unsigned int low = 0U;
+	unsigned int high = partition_table_count;
+
+	while (low < high) {
+		unsigned int mid = (low + high) / 2U;
+
+		if (partition_table[mid].id == id) {
+			return &partition_table[mid];
+		}
+
+		if (partition_table[mid].id < id) {
+			low = mid + 1U;
+		} else {
+			high = mid;
+		}
+	}
+
+	return NULL;
+}
+
 /*
  * Helper function to obtain the descriptor of the Hypervisor or OS kernel.
  * We assume that the first descriptor is reserved for this entity.
@@ -264,7 +340,7 @@ static inline bool direct_msg_validate_arg2(uint64_t x2)
  ******************************************************************************/
 static bool direct_msg_validate_dst_id(uint16_t dst_id)
 {
-	struct secure_partition_desc *sp;
+	const struct partition_entry *dst;
 
 	/* Check if we're targeting a normal world partition. */
 	if (ffa_is_normal_world_id(dst_id)) {
@@ -277,8 +353,8 @@ static bool direct_msg_validate_dst_id(uint16_t dst_id)
 	}
 
 	/* Otherwise ensure the SP exists. */
-	sp = spmc_get_sp_ctx(dst_id);
-	if (sp != NULL) {
+	dst = partition_table_lookup(dst_id);
+	if ((dst != NULL) && (dst->sp != NULL)) {
 		return true;
 	}
 
@@ -333,7 +409,7 @@ static uint64_t direct_req_smc_handler(uint32_t smc_fid,
 {
 	uint16_t src_id = ffa_endpoint_source(x1);
 	uint16_t dst_id = ffa_endpoint_destination(x1);
-	struct el3_lp_desc *el3_lp_descs;
+	const struct partition_entry *dst;
 	struct secure_partition_desc *sp;
 	unsigned int idx;
 
@@ -351,22 +427,19 @@ static uint64_t direct_req_smc_handler(uint32_t smc_fid,
 					FFA_ERROR_INVALID_PARAMETER);
 	}
 
-	el3_lp_descs = get_el3_lp_array();
+	dst = partition_table_lookup(dst_id);
 
 	/* Check if the request is destined for a Logical Partition. */
-	for (unsigned int i = 0U; i < MAX_EL3_LP_DESCS_COUNT; i++) {
-		if (el3_lp_descs[i].sp_id == dst_id) {
-			uint64_t ret = el3_lp_descs[i].direct_req(
-						smc_fid, secure_origin, x1, x2,
-						x3, x4, cookie, handle, flags);
-			if (!direct_msg_validate_lp_resp(src_id, dst_id,
-							 handle)) {
-				panic();
-			}
-
-			/* Message checks out. */
-			return ret;
+	if ((dst != NULL) && (dst->lp != NULL)) {
+		uint64_t ret = dst->lp->direct_req(smc_fid, secure_origin,
+						   x1, x2, x3, x4, cookie,
+						   handle, flags);
+		if (!direct_msg_validate_lp_resp(src_id, dst_id, handle)) {
+			panic();
 		}
+
+		/* Message checks out. */
+		return ret;
 	}
 
 	/*
@@ -382,13 +455,13 @@ static uint64_t direct_req_smc_handler(uint32_t smc_fid,
 	}
 
 	/* Check if the SP ID is valid. */
-	sp = spmc_get_sp_ctx(dst_id);
-	if (sp == NULL) {
+	if (dst == NULL) {
 		VERBOSE("Direct request to unknown partition ID (0x%x).\n",
 			dst_id);
 		return spmc_ffa_error_return(handle,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
+	sp = dst->sp;
 
 	/*
 	 * Check that the target execution context is in a waiting state before
@@ -408,8 +481,11 @@ static uint64_t direct_req_smc_handler(uint32_t smc_fid,
 	sp->ec[idx].rt_state = RT_STATE_RUNNING;
 	sp->ec[idx].rt_model = RT_MODEL_DIR_REQ;
 	sp->ec[idx].dir_req_origin_id = src_id;
-	return spmc_smc_return(smc_fid, secure_origin, x1, x2, x3, x4,
-			       handle, cookie, flags, dst_id);
+	sp->dir_req_count[plat_my_core_pos()]++;
+
+	/* The request comes from the Normal world, switch to the SP. */
+	return spmd_smc_switch_state(smc_fid, secure_origin, x1, x2, x3, x4,
+				     handle);
 }
 
 /*******************************************************************************
@@ -426,6 +502,7 @@ static uint64_t direct_resp_smc_handler(uint32_t smc_fid,
 					uint64_t flags)
 {
 	uint16_t dst_id = ffa_endpoint_destination(x1);
+	const struct partition_entry *src;
 	struct secure_partition_desc *sp;
 	unsigned int idx;
 
@@ -454,13 +531,14 @@ static uint64_t direct_resp_smc_handler(uint32_t smc_fid,
 	}
 
 	/* Obtain the SP descriptor and update its runtime state. */
-	sp = spmc_get_sp_ctx(ffa_endpoint_source(x1));
-	if (sp == NULL) {
+	src = partition_table_lookup(ffa_endpoint_source(x1));
+	if ((src == NULL) || (src->sp == NULL)) {
 		VERBOSE("Direct response to unknown partition ID (0x%x).\n",
 			dst_id);
 		return spmc_ffa_error_return(handle,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
+	sp = src->sp;
 
 	/* Sanity check state is being tracked correctly in the SPMC. */
 	idx = get_ec_index(sp);
@@ -484,6 +562,7 @@ static uint64_t direct_resp_smc_handler(uint32_t smc_fid,
 
 	/* Clear the ongoing direct request ID. */
 	sp->ec[idx].dir_req_origin_id = INV_SP_ID;
+	sp->dir_resp_count[plat_my_core_pos()]++;
 
 	/*
 	 * If the receiver is not the SPMC then forward the response to the
@@ -495,10 +574,51 @@ static uint64_t direct_resp_smc_handler(uint32_t smc_fid,
 		panic();
 	}
 
-	return spmc_smc_return(smc_fid, secure_origin, x1, x2, x3, x4,
-			       handle, cookie, flags, dst_id);
+	/*
+	 * Only the Normal world can send direct requests to an SP. The SPMD
+	 * would just forward the response to it, so switch to it directly
+	 * rather than going through the SPMD SMC handler.
+	 */
+	assert(ffa_is_normal_world_id(dst_id));
+	return spmd_smc_switch_state(smc_fid, secure_origin, x1, x2, x3, x4,
+				     handle);
+}
+
+#if ENABLE_PMF
+/*******************************************************************************
+ * PMF handler returning a direct message counter of an SP on a CPU, see
+ * spmc_svc.h.
+ ******************************************************************************/
+static unsigned long long spmc_dir_msg_stats_get(unsigned int tid,
+						 u_register_t mpidr,
+						 unsigned int flags)
+{
+	unsigned int index = (tid >> SPMC_DIR_MSG_STATS_SP_SHIFT) &
+			     SPMC_DIR_MSG_STATS_SP_MASK;
+	int cpu;
+
+	/* The PMF framework already checked both */
+	cpu = plat_core_pos_by_mpidr(mpidr);
+	assert((cpu >= 0) &&
+	       ((tid & PMF_TID_MASK) < SPMC_DIR_MSG_STATS_TOTAL_IDS));
+
+	if (index >= SECURE_PARTITION_COUNT) {
+		return 0ULL;
+	}
+
+	if ((tid & PMF_TID_MASK) == SPMC_DIR_MSG_STATS_REQS) {
+		return sp_desc[index].dir_req_count[cpu];
+	}
+
+	return sp_desc[index].dir_resp_count[cpu];
 }
 
+PMF_REGISTER_SERVICE_SMC_OWN(spmc_dir_msg, PMF_ARM_TIF_IMPL_ID,
+			     PMF_SPMC_DIR_MSG_SVC_ID,
+			     SPMC_DIR_MSG_STATS_TOTAL_IDS,
+			     NULL, spmc_dir_msg_stats_get)
+#endif /* ENABLE_PMF */
+
 /*******************************************************************************
  * This function handles the FFA_MSG_WAIT SMC to allow an SP to relinquish its
  * cycles.
@@ -1921,6 +2041,9 @@ int32_t spmc_setup(void)
 		return ret;
 	}
 
+	/* All partitions are known, index them by ID. */
+	partition_table_init();
+
 	/* Register power management hooks with PSCI */
 	psci_register_spd_pm_hook(&spmc_pm);
 
@@ -20,6 +20,11 @@
 
 /**
  * struct spmc_shmem_obj - Shared memory object.
+ * @block_size:     Size of the datastore block holding this object, including
+ *                  this header.
+ * @prev_block_size: Size of the block located just before this one in the
+ *                  datastore, 0 for the first block.
+ * @free:           True if the block is on the free list.
  * @desc_size:      Size of @desc.
  * @desc_filled:    Size of @desc already received.
  * @in_use:         Number of clients that have called ffa_mem_retrieve_req
@@ -27,12 +32,39 @@
  * @desc:           FF-A memory region descriptor passed in ffa_mem_share.
  */
 struct spmc_shmem_obj {
+	size_t block_size;
+	size_t prev_block_size;
+	bool free;
 	size_t desc_size;
 	size_t desc_filled;
 	size_t in_use;
 	struct ffa_mtd desc;
 };
 
+/**
+ * struct spmc_shmem_free_links - Free list links, stored in the descriptor
+ *                                area of a free block.
+ * @next:           Next free block, or %NULL.
+ * @prev:           Previous free block, or %NULL.
+ */
+struct spmc_shmem_free_links {
+	struct spmc_shmem_obj *next;
+	struct spmc_shmem_obj *prev;
+};
+
+/* Smallest block the datastore is split into, so it can hold free links. */
+#define SPMC_SHMEM_MIN_BLOCK_SIZE	\
+	(offsetof(struct spmc_shmem_obj, desc) + 16U)
+
+CASSERT((offsetof(struct spmc_shmem_obj, desc) % 16U) == 0U,
+	assert_spmc_shmem_obj_desc_alignment);
+CASSERT(sizeof(struct spmc_shmem_free_links) <= 16U,
+	assert_spmc_shmem_free_links_size);
+#ifdef PLAT_SPMC_SHMEM_OBJ_INDEX_SLOTS
+CASSERT(IS_POWER_OF_TWO(PLAT_SPMC_SHMEM_OBJ_INDEX_SLOTS),
+	assert_spmc_shmem_obj_index_slots_power_of_2);
+#endif
+
 /*
  * Declare our data structure to store the metadata of memory share requests.
  * The main datastore is allocated on a per platform basis to ensure enough
@@ -57,22 +89,151 @@ static size_t spmc_shmem_obj_size(size_t desc_size)
 	return desc_size + offsetof(struct spmc_shmem_obj, desc);
 }
 
+static struct spmc_shmem_free_links *
+spmc_shmem_free_links(struct spmc_shmem_obj *obj)
+{
+	return (struct spmc_shmem_free_links *)&obj->desc;
+}
+
+/* Return the block located just after @obj, or %NULL if @obj is the last. */
+static struct spmc_shmem_obj *
+spmc_shmem_block_next(struct spmc_shmem_obj_state *state,
+		      struct spmc_shmem_obj *obj)
+{
+	uint8_t *next = (uint8_t *)obj + obj->block_size;
+
+	if ((size_t)(next - state->data) >= state->block_end) {
+		return NULL;
+	}
+	return (struct spmc_shmem_obj *)next;
+}
+
+/* Return the block located just before @obj, or %NULL if @obj is the first. */
+static struct spmc_shmem_obj *
+spmc_shmem_block_prev(struct spmc_shmem_obj *obj)
+{
+	if (obj->prev_block_size == 0U) {
+		return NULL;
+	}
+	return (struct spmc_shmem_obj *)((uint8_t *)obj - obj->prev_block_size);
+}
+
+static void spmc_shmem_free_list_add(struct spmc_shmem_obj_state *state,
+				     struct spmc_shmem_obj *obj)
+{
+	struct spmc_shmem_free_links *links = spmc_shmem_free_links(obj);
+
+	obj->free = true;
+	links->prev = NULL;
+	links->next = state->free_list;
+	if (state->free_list != NULL) {
+		spmc_shmem_free_links(state->free_list)->prev = obj;
+	}
+	state->free_list = obj;
+}
+
+static void spmc_shmem_free_list_remove(struct spmc_shmem_obj_state *state,
+					struct spmc_shmem_obj *obj)
+{
+	struct spmc_shmem_free_links *links = spmc_shmem_free_links(obj);
+
+	if (links->prev != NULL) {
+		spmc_shmem_free_links(links->prev)->next = links->next;
+	} else {
+		state->free_list = links->next;
+	}
+	if (links->next != NULL) {
+		spmc_shmem_free_links(links->next)->prev = links->prev;
+	}
+	obj->free = false;
+}
+
+/*
+ * Set the size of block @obj and record it in the block that follows, so
+ * that neighbours can be found in constant time when @obj is freed.
+ */
+static void spmc_shmem_block_resize(struct spmc_shmem_obj_state *state,
+				    struct spmc_shmem_obj *obj, size_t size)
+{
+	struct spmc_shmem_obj *next;
+
+	obj->block_size = size;
+	next = spmc_shmem_block_next(state, obj);
+	if (next != NULL) {
+		next->prev_block_size = size;
+	}
+}
+
+/* Number of slots of the handle index, for a datastore of @data_size bytes */
+static size_t spmc_shmem_index_slots(size_t data_size)
+{
+#ifdef PLAT_SPMC_SHMEM_OBJ_INDEX_SLOTS
+	return PLAT_SPMC_SHMEM_OBJ_INDEX_SLOTS;
+#else
+	size_t slots = SPMC_SHMEM_MIN_INDEX_SLOTS;
+
+	while ((slots * 2U) <= (data_size / SPMC_SHMEM_DATA_PER_INDEX_SLOT)) {
+		slots *= 2U;
+	}
+
+	return slots;
+#endif
+}
+
+/*
+ * Take the handle index from the start of the datastore and turn the rest into
+ * a single free block. Called on first use, as the datastore is provided by
+ * the platform and zeroed by spmc_setup().
+ */
+static void spmc_shmem_datastore_init(struct spmc_shmem_obj_state *state)
+{
+	struct spmc_shmem_obj *obj;
+	size_t slots = spmc_shmem_index_slots(state->data_size);
+	size_t index_size = round_up(slots * sizeof(*state->index), 16U);
+
+	state->initialized = true;
+	if (index_size >= state->data_size) {
+		ERROR("shmem datastore too small for %zu index slots\n", slots);
+		state->data_size = 0U;
+		state->block_end = 0U;
+		return;
+	}
+
+	state->index = (struct spmc_shmem_obj **)state->data;
+	state->index_slots = slots;
+	state->data += index_size;
+	state->data_size -= index_size;
+
+	obj = (struct spmc_shmem_obj *)state->data;
+	state->block_end = state->data_size & ~(size_t)15U;
+	if (state->block_end < SPMC_SHMEM_MIN_BLOCK_SIZE) {
+		state->block_end = 0U;
+		return;
+	}
+
+	obj->block_size = state->block_end;
+	obj->prev_block_size = 0U;
+	spmc_shmem_free_list_add(state, obj);
+}
+
 /**
  * spmc_shmem_obj_alloc - Allocate struct spmc_shmem_obj.
  * @state:      Global state.
  * @desc_size:  Size of struct ffa_memory_region_descriptor object that
  *              allocated object will hold.
  *
+ * The first free block large enough is used, and split if the remainder
+ * can hold another object.
+ *
  * Return: Pointer to newly allocated object, or %NULL if there not enough space
- *         left. The returned pointer is only valid while @state is locked, to
- *         used it again after unlocking @state, spmc_shmem_obj_lookup must be
- *         called.
+ *         left. Objects never move, the returned pointer stays valid until the
+ *         object is freed.
  */
 static struct spmc_shmem_obj *
 spmc_shmem_obj_alloc(struct spmc_shmem_obj_state *state, size_t desc_size)
 {
 	struct spmc_shmem_obj *obj;
-	size_t free = state->data_size - state->allocated;
+	size_t largest = 0U;
 	size_t obj_size;
 
 	if (state->data == NULL) {
@@ -80,6 +241,10 @@ spmc_shmem_obj_alloc(struct spmc_shmem_obj_state *state, size_t desc_size)
 		return NULL;
 	}
 
+	if (!state->initialized) {
+		spmc_shmem_datastore_init(state);
+	}
+
 	/* Ensure that descriptor size is aligned */
 	if (!is_aligned(desc_size, 16)) {
 		WARN("%s(0x%zx) desc_size not 16-byte aligned\n",
@@ -96,45 +261,162 @@ spmc_shmem_obj_alloc(struct spmc_shmem_obj_state *state, size_t desc_size)
 		return NULL;
 	}
 
-	if (obj_size > free) {
-		WARN("%s(0x%zx) failed, free 0x%zx\n",
-		     __func__, desc_size, free);
+	if (obj_size < SPMC_SHMEM_MIN_BLOCK_SIZE) {
+		obj_size = SPMC_SHMEM_MIN_BLOCK_SIZE;
+	}
+
+	for (obj = state->free_list; obj != NULL;
+	     obj = spmc_shmem_free_links(obj)->next) {
+		if (obj->block_size >= obj_size) {
+			break;
+		}
+		largest = MAX(largest, obj->block_size);
+	}
+
+	if (obj == NULL) {
+		WARN("%s(0x%zx) failed, largest free block 0x%zx\n",
+		     __func__, desc_size, largest);
 		return NULL;
 	}
-	obj = (struct spmc_shmem_obj *)(state->data + state->allocated);
+
+	spmc_shmem_free_list_remove(state, obj);
+
+	/* Split off the remainder if it is large enough to be useful. */
+	if ((obj->block_size - obj_size) >= SPMC_SHMEM_MIN_BLOCK_SIZE) {
+		struct spmc_shmem_obj *rest;
+		size_t rest_size = obj->block_size - obj_size;
+
+		obj->block_size = obj_size;
+		rest = spmc_shmem_block_next(state, obj);
+		rest->prev_block_size = obj_size;
+		spmc_shmem_block_resize(state, rest, rest_size);
+		spmc_shmem_free_list_add(state, rest);
+	}
+
 	obj->desc = (struct ffa_mtd) {0};
 	obj->desc_size = desc_size;
 	obj->desc_filled = 0;
 	obj->in_use = 0;
-	state->allocated += obj_size;
+	state->allocated += obj->block_size;
 	return obj;
 }
 
+/**
+ * spmc_shmem_obj_hash - Return the index slot an object handle hashes to.
+ * @state:      Global state.
+ * @handle:     Object handle.
+ *
+ * Handles are allocated sequentially, so folding the two halves is enough to
+ * spread them over the slots.
+ */
+static size_t spmc_shmem_obj_hash(const struct spmc_shmem_obj_state *state,
+				  uint64_t handle)
+{
+	return (size_t)((handle ^ (handle >> 32)) & (state->index_slots - 1U));
+}
+
+/**
+ * spmc_shmem_obj_index_add - Make an object reachable by its handle.
+ * @state:      Global state.
+ * @obj:        Object with a newly assigned handle.
+ *
+ * The index uses open addressing with linear probing, and is kept at most
+ * three quarters full so that probe sequences stay short.
+ *
+ * Return: 0 on success, -ENOMEM if the index is full.
+ */
+static int spmc_shmem_obj_index_add(struct spmc_shmem_obj_state *state,
+				    struct spmc_shmem_obj *obj)
+{
+	size_t slot = spmc_shmem_obj_hash(state, obj->desc.handle);
+
+	if (state->index_count >= ((state->index_slots * 3U) / 4U)) {
+		WARN("%s: too many shared memory objects\n", __func__);
+		return -ENOMEM;
+	}
+
+	while (state->index[slot] != NULL) {
+		slot = (slot + 1U) & (state->index_slots - 1U);
+	}
+	state->index[slot] = obj;
+	state->index_count++;
+
+	return 0;
+}
+
+/**
+ * spmc_shmem_obj_index_remove - Remove an object from the handle index.
+ * @state:      Global state.
+ * @obj:        Object to remove. Objects that are not indexed are ignored.
+ *
+ * Entries following the removed one in its probe sequence are shifted back,
+ * so that no tombstones are needed and lookups stay short.
+ */
+static void spmc_shmem_obj_index_remove(struct spmc_shmem_obj_state *state,
+					struct spmc_shmem_obj *obj)
+{
+	const size_t mask = state->index_slots - 1U;
+	size_t slot = spmc_shmem_obj_hash(state, obj->desc.handle);
+	size_t next;
+
+	while (state->index[slot] != obj) {
+		if (state->index[slot] == NULL) {
+			return;
+		}
+		slot = (slot + 1U) & mask;
+	}
+
+	state->index[slot] = NULL;
+	state->index_count--;
+
+	for (next = (slot + 1U) & mask; state->index[next] != NULL;
+	     next = (next + 1U) & mask) {
+		size_t home = spmc_shmem_obj_hash(state,
+					state->index[next]->desc.handle);
+
+		/* Move the entry unless its home is cyclically in (slot, next] */
+		if (((next - home) & mask) >= ((next - slot) & mask)) {
+			state->index[slot] = state->index[next];
+			state->index[next] = NULL;
+			slot = next;
+		}
+	}
+}
+
 /**
  * spmc_shmem_obj_free - Free struct spmc_shmem_obj.
  * @state:      Global state.
  * @obj:        Object to free.
  *
- * Release memory used by @obj. Other objects may move, so on return all
- * pointers to struct spmc_shmem_obj object should be considered invalid, not
- * just @obj.
- *
- * The current implementation always compacts the remaining objects to simplify
- * the allocator and to avoid fragmentation.
+ * Release memory used by @obj and remove it from the handle index. Other
+ * objects are not affected. The block is merged with free neighbours, which
+ * are found in constant time through the block size fields, to limit
+ * fragmentation.
  */
 
 static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
 				  struct spmc_shmem_obj *obj)
 {
-	size_t free_size = spmc_shmem_obj_size(obj->desc_size);
-	uint8_t *shift_dest = (uint8_t *)obj;
-	uint8_t *shift_src = shift_dest + free_size;
-	size_t shift_size = state->allocated - (shift_src - state->data);
+	struct spmc_shmem_obj *next = spmc_shmem_block_next(state, obj);
+	struct spmc_shmem_obj *prev = spmc_shmem_block_prev(obj);
+	size_t size = obj->block_size;
+
+	spmc_shmem_obj_index_remove(state, obj);
+	state->allocated -= obj->block_size;
+
+	if ((next != NULL) && next->free) {
+		spmc_shmem_free_list_remove(state, next);
+		size += next->block_size;
+	}
 
-	if (shift_size != 0U) {
-		memmove(shift_dest, shift_src, shift_size);
+	if ((prev != NULL) && prev->free) {
+		spmc_shmem_free_list_remove(state, prev);
+		size += prev->block_size;
+		obj = prev;
 	}
-	state->allocated -= free_size;
+
+	spmc_shmem_block_resize(state, obj, size);
+	spmc_shmem_free_list_add(state, obj);
 }
 
 /**
@@ -148,15 +430,19 @@ static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
 static struct spmc_shmem_obj *
 spmc_shmem_obj_lookup(struct spmc_shmem_obj_state *state, uint64_t handle)
 {
-	uint8_t *curr = state->data;
+	size_t slot;
 
-	while (curr - state->data < state->allocated) {
-		struct spmc_shmem_obj *obj = (struct spmc_shmem_obj *)curr;
+	/* Nothing is indexed before the first object is allocated */
+	if (state->index_slots == 0U) {
+		return NULL;
+	}
 
-		if (obj->desc.handle == handle) {
-			return obj;
+	slot = spmc_shmem_obj_hash(state, handle);
+	while (state->index[slot] != NULL) {
+		if (state->index[slot]->desc.handle == handle) {
+			return state->index[slot];
 		}
-		curr += spmc_shmem_obj_size(obj->desc_size);
+		slot = (slot + 1U) & (state->index_slots - 1U);
 	}
 	return NULL;
 }
@@ -173,14 +459,15 @@ spmc_shmem_obj_lookup(struct spmc_shmem_obj_state *state, uint64_t handle)
 static struct spmc_shmem_obj *
 spmc_shmem_obj_get_next(struct spmc_shmem_obj_state *state, size_t *offset)
 {
-	uint8_t *curr = state->data + *offset;
-
-	if (curr - state->data < state->allocated) {
-		struct spmc_shmem_obj *obj = (struct spmc_shmem_obj *)curr;
+	while (*offset < state->block_end) {
+		struct spmc_shmem_obj *obj =
+			(struct spmc_shmem_obj *)(state->data + *offset);
 
-		*offset += spmc_shmem_obj_size(obj->desc_size);
+		*offset += obj->block_size;
 
-		return obj;
+		if (!obj->free) {
+			return obj;
+		}
 	}
 	return NULL;
 }
@@ -348,6 +635,116 @@ overlapping_memory_regions(struct ffa_comp_mrd *region1,
 	return false;
 }
 
+/*
+ * Address range of a constituent. Once sorted by start address, @end holds the
+ * largest end address of this range and all the ones before it.
+ */
+struct spmc_shmem_range {
+	uint64_t start;
+	uint64_t end;
+};
+
+/* Restore the max-heap property of @ranges[0..@count) below @root. */
+static void spmc_shmem_range_sift_down(struct spmc_shmem_range *ranges,
+				       size_t root, size_t count)
+{
+	struct spmc_shmem_range tmp;
+	size_t child;
+
+	for (child = (2U * root) + 1U; child < count;
+	     child = (2U * root) + 1U) {
+		if (((child + 1U) < count) &&
+		    (ranges[child + 1U].start > ranges[child].start)) {
+			child++;
+		}
+
+		if (ranges[root].start >= ranges[child].start) {
+			return;
+		}
+
+		tmp = ranges[root];
+		ranges[root] = ranges[child];
+		ranges[child] = tmp;
+		root = child;
+	}
+}
+
+/*
+ * Sort @ranges by start address, then turn their end addresses into a running
+ * maximum. Heapsort is used as it needs neither recursion nor extra memory.
+ */
+static void spmc_shmem_range_sort(struct spmc_shmem_range *ranges,
+				  size_t count)
+{
+	struct spmc_shmem_range tmp;
+
+	for (size_t i = count / 2U; i > 0U; i--) {
+		spmc_shmem_range_sift_down(ranges, i - 1U, count);
+	}
+
+	for (size_t i = count; i > 1U; i--) {
+		tmp = ranges[0];
+		ranges[0] = ranges[i - 1U];
+		ranges[i - 1U] = tmp;
+		spmc_shmem_range_sift_down(ranges, 0U, i - 1U);
+	}
+
+	for (size_t i = 1U; i < count; i++) {
+		if (ranges[i].end < ranges[i - 1U].end) {
+			ranges[i].end = ranges[i - 1U].end;
+		}
+	}
+}
+
+/*
+ * Return true if [@start, @end) overlaps one of the ranges sorted by
+ * spmc_shmem_range_sort(). Only the ranges starting before @end can overlap
+ * it, and one of them does if the largest of their end addresses is above
+ * @start.
+ */
+static bool spmc_shmem_range_overlaps(const struct spmc_shmem_range *ranges,
+				      size_t count, uint64_t start,
+				      uint64_t end)
+{
+	size_t low = 0U;
+	size_t high = count;
+
+	while (low < high) {
+		size_t mid = (low + high) / 2U;
+
+		if (ranges[mid].start < end) {
+			low = mid + 1U;
+		} else {
+			high = mid;
+		}
+	}
+
+	return (low > 0U) && (ranges[low - 1U].end > start);
+}
+
+/*
+ * Same as overlapping_memory_regions(), with the address ranges of the first
+ * region sorted by spmc_shmem_range_sort().
+ */
+static bool
+overlapping_sorted_ranges(const struct spmc_shmem_range *ranges, size_t count,
+			  struct ffa_comp_mrd *region)
+{
+	for (size_t i = 0; i < region->address_range_count; i++) {
+		uint64_t start = region->address_range_array[i].address;
+		uint64_t end = start +
+			(region->address_range_array[i].page_count *
+			 PAGE_SIZE_4KB);
+
+		if (spmc_shmem_range_overlaps(ranges, count, start, end)) {
+			WARN("Overlapping mem region 0x%lx-0x%lx\n",
+			     start, end);
+			return true;
+		}
+	}
+	return false;
+}
+
 /*******************************************************************************
  * FF-A v1.0 Memory Descriptor Conversion Helpers.
  ******************************************************************************/
@@ -632,8 +1029,6 @@ spmc_shm_convert_mtd_to_v1_0(struct spmc_shmem_obj *out_obj,
  *                  descriptor.
  *
  * Return: 0 if conversion and population succeeded.
- * Note: This function invalidates the reference to @orig therefore
- * `spmc_shmem_obj_lookup` must be called if further usage is required.
  */
 static uint32_t
 spmc_populate_ffa_v1_0_descriptor(void *dst, struct spmc_shmem_obj *orig_obj,
@@ -669,11 +1064,7 @@ spmc_populate_ffa_v1_0_descriptor(void *dst, struct spmc_shmem_obj *orig_obj,
 		*copy_size = MIN(v1_0_obj->desc_size - offset, buf_size);
 		memcpy(dst, (uint8_t *) &v1_0_obj->desc + offset, *copy_size);
 
-		/*
-		 * We're finished with the v1.0 descriptor for now so free it.
-		 * Note that this will invalidate any references to the v1.1
-		 * descriptor.
-		 */
+		/* We're finished with the v1.0 descriptor for now so free it. */
 		spmc_shmem_obj_free(&spmc_shmem_obj_state, v1_0_obj);
 
 		return 0;
@@ -962,6 +1353,10 @@ static int spmc_shmem_check_state_obj(struct spmc_shmem_obj *obj,
 {
 	size_t obj_offset = 0;
 	struct spmc_shmem_obj *inflight_obj;
+	struct spmc_shmem_obj *ranges_obj = NULL;
+	struct spmc_shmem_range *ranges = NULL;
+	size_t count;
+	int ret = 0;
 
 	struct ffa_comp_mrd *other_mrd;
 	struct ffa_comp_mrd *requested_mrd = spmc_shmem_obj_get_comp_mrd(obj,
@@ -971,31 +1366,69 @@ static int spmc_shmem_check_state_obj(struct spmc_shmem_obj *obj,
 		return FFA_ERROR_INVALID_PARAMETER;
 	}
 
+	/*
+	 * Sort the address ranges of the request in a temporary object, so
+	 * that each address range of the other transactions is checked with a
+	 * binary search rather than against every range of the request. Fall
+	 * back to comparing all pairs of ranges if there is no space for it.
+	 */
+	count = requested_mrd->address_range_count;
+	if (count != 0U) {
+		ranges_obj = spmc_shmem_obj_alloc(&spmc_shmem_obj_state,
+				round_up(MAX(count * sizeof(*ranges),
+					     sizeof(struct ffa_mtd)), 16U));
+	}
+
+	if (ranges_obj != NULL) {
+		ranges = (struct spmc_shmem_range *)&ranges_obj->desc;
+		for (size_t i = 0U; i < count; i++) {
+			const struct ffa_cons_mrd *mrd =
+				&requested_mrd->address_range_array[i];
+
+			ranges[i].start = mrd->address;
+			ranges[i].end = mrd->address +
+					(mrd->page_count * PAGE_SIZE_4KB);
+		}
+		spmc_shmem_range_sort(ranges, count);
+	}
+
 	inflight_obj = spmc_shmem_obj_get_next(&spmc_shmem_obj_state,
 					       &obj_offset);
 
 	while (inflight_obj != NULL) {
 		/*
 		 * Don't compare the transaction to itself or to partially
-		 * transmitted descriptors.
+		 * transmitted descriptors. The latter include the temporary
+		 * object holding the sorted ranges.
 		 */
 		if ((obj->desc.handle != inflight_obj->desc.handle) &&
-		    (obj->desc_size == obj->desc_filled)) {
+		    (inflight_obj->desc_size == inflight_obj->desc_filled)) {
 			other_mrd = spmc_shmem_obj_get_comp_mrd(inflight_obj,
 							  FFA_VERSION_COMPILED);
 			if (other_mrd == NULL) {
-				return FFA_ERROR_INVALID_PARAMETER;
+				ret = FFA_ERROR_INVALID_PARAMETER;
+				break;
 			}
-			if (overlapping_memory_regions(requested_mrd,
+
+			if ((ranges != NULL) ?
+			    overlapping_sorted_ranges(ranges, count,
+						      other_mrd) :
+			    overlapping_memory_regions(requested_mrd,
 						       other_mrd)) {
-				return FFA_ERROR_INVALID_PARAMETER;
+				ret = FFA_ERROR_INVALID_PARAMETER;
+				break;
 			}
 		}
 
 		inflight_obj = spmc_shmem_obj_get_next(&spmc_shmem_obj_state,
 						       &obj_offset);
 	}
-	return 0;
+
+	if (ranges_obj != NULL) {
+		spmc_shmem_obj_free(&spmc_shmem_obj_state, ranges_obj);
+	}
+
+	return ret;
 }
 
 static long spmc_ffa_fill_desc(struct mailbox *mbox,
@@ -1070,6 +1503,12 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 
 		obj->desc.handle = spmc_shmem_obj_state.next_handle++;
 		obj->desc.flags |= mtd_flag;
+
+		if (spmc_shmem_obj_index_add(&spmc_shmem_obj_state,
+					     obj) != 0) {
+			ret = FFA_ERROR_NO_MEMORY;
+			goto err_arg;
+		}
 	}
 
 	obj->desc_filled += fragment_length;
@@ -1102,7 +1541,6 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 	 */
 	if (ffa_version == MAKE_FFA_VERSION(1, 0)) {
 		struct spmc_shmem_obj *v1_1_obj;
-		uint64_t mem_handle;
 
 		/* Calculate the size that the v1.1 descriptor will required. */
 		uint64_t v1_1_desc_size =
@@ -1134,16 +1572,17 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 
 		/*
 		 * We're finished with the v1.0 descriptor so free it
-		 * and continue our checks with the new v1.1 descriptor.
+		 * and continue our checks with the new v1.1 descriptor,
+		 * which takes over its handle.
 		 */
-		mem_handle = obj->desc.handle;
 		spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
-		obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
-		if (obj == NULL) {
-			ERROR("%s: Failed to find converted descriptor.\n",
+		obj = v1_1_obj;
+		if (spmc_shmem_obj_index_add(&spmc_shmem_obj_state,
+					     obj) != 0) {
+			ERROR("%s: Failed to index converted descriptor.\n",
 			     __func__);
-			ret = FFA_ERROR_INVALID_PARAMETER;
-			return spmc_ffa_error_return(smc_handle, ret);
+			ret = FFA_ERROR_NO_MEMORY;
+			goto err_arg;
 		}
 	}
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2022-2023, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,8 +7,12 @@
 #ifndef SPMC_SHARED_MEM_H
 #define SPMC_SHARED_MEM_H
 
+#include <stdbool.h>
+
 #include <services/el3_spmc_ffa_memory.h>
 
+#include <platform_def.h>
+
 /**
  * struct ffa_mem_relinquish_descriptor - Relinquish request descriptor.
  * @handle:
@@ -31,6 +35,19 @@ struct ffa_mem_relinquish_descriptor {
 CASSERT(sizeof(struct ffa_mem_relinquish_descriptor) == 16,
 	assert_ffa_mem_relinquish_descriptor_size_mismatch);
 
+/*
+ * The handle index of shared memory objects is taken from the start of the
+ * datastore. A platform may set its number of slots, a power of 2, with
+ * PLAT_SPMC_SHMEM_OBJ_INDEX_SLOTS. Otherwise there is a slot for each
+ * SPMC_SHMEM_DATA_PER_INDEX_SLOT bytes of datastore, rounded down to a power
+ * of 2. At most three quarters of the slots are used, which bounds the number
+ * of live shared memory objects.
+ */
+#define SPMC_SHMEM_DATA_PER_INDEX_SLOT	128U
+#define SPMC_SHMEM_MIN_INDEX_SLOTS	16U
+
+struct spmc_shmem_obj;
+
 /**
  * struct spmc_shmem_obj_state - Global state.
  * @data:           Backing store for spmc_shmem_obj objects.
@@ -38,6 +55,12 @@ CASSERT(sizeof(struct ffa_mem_relinquish_descriptor) == 16,
  * @allocated:      Number of bytes allocated in @data.
  * @next_handle:    Handle used for next allocated object.
  * @lock:           Lock protecting all state in this file.
+ * @initialized:    True once @data has been turned into a free block.
+ * @block_end:      Offset of the end of the last block in @data.
+ * @free_list:      List of free blocks in @data.
+ * @index_slots:    Number of slots of @index, a power of 2.
+ * @index_count:    Number of objects in @index.
+ * @index:          Open-addressed hash table of objects, keyed by handle.
  */
 struct spmc_shmem_obj_state {
 	uint8_t *data;
@@ -45,6 +68,12 @@ struct spmc_shmem_obj_state {
 	size_t allocated;
 	uint64_t next_handle;
 	spinlock_t lock;
+	bool initialized;
+	size_t block_end;
+	struct spmc_shmem_obj *free_list;
+	size_t index_slots;
+	size_t index_count;
+	struct spmc_shmem_obj **index;
 };
 
 extern struct spmc_shmem_obj_state spmc_shmem_obj_state;
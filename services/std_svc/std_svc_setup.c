@@ -13,6 +13,7 @@
 #include <lib/pmf/pmf.h>
 #include <lib/psci/psci.h>
 #include <lib/runtime_instr.h>
+#include <lib/trace_log/trace_log.h>
 #include <services/drtm_svc.h>
 #include <services/errata_abi_svc.h>
 #include <services/pci_svc.h>
@@ -111,6 +112,18 @@ static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 		x4 &= UINT32_MAX;
 	}
 
+	/*
+	 * The trace log can be read by the normal world, so the arguments of
+	 * calls from the secure and realm worlds are not recorded.
+	 */
+	if (is_caller_non_secure(flags)) {
+		TRACE_EVENT("std_svc: fid 0x%x x1 0x%lx x2 0x%lx x3 0x%lx\n",
+			    smc_fid, x1, x2, x3);
+	} else {
+		TRACE_EVENT("std_svc: fid 0x%x from secure or realm world\n",
+			    smc_fid);
+	}
+
 	/*
 	 * Dispatch PSCI calls to PSCI SMC handler and return its return
 	 * value
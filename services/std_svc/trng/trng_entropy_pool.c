@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2021-2022, ARM Limited. All rights reserved.
+ * Copyright (c) 2021-2023, ARM Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,8 +7,17 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
+
+#include <platform_def.h>
+
+#include <lib/el3_runtime/pubsub_events.h>
+#include <lib/pmf/pmf.h>
 #include <lib/spinlock.h>
 #include <plat/common/plat_trng.h>
+#include <plat/common/platform.h>
+#include <services/trng_svc.h>
+
+#include "trng_entropy_pool.h"
 
 /*
  * # Entropy pool
@@ -17,64 +26,94 @@
  * so that when we have 1-63 bits in the pool, and we have a request for
  * 192 bits of entropy, we don't have to throw out the leftover 1-63 bits of
  * entropy.
+ *
+ * Each CPU has its own pool, only accessed by that CPU, so that requests
+ * served from the pool do not contend with the other CPUs. Only the accesses
+ * to the entropy source are serialised. The pool is refilled in full whenever
+ * it runs short, and topped up on entry into a power down state.
  */
 #define WORDS_IN_POOL	(4)
-static uint64_t entropy[WORDS_IN_POOL];
-/* index in bits of the first bit of usable entropy */
-static uint32_t entropy_bit_index;
-/* then number of valid bits in the entropy pool */
-static uint32_t entropy_bit_size;
 
-static spinlock_t trng_pool_lock;
+struct trng_pool {
+	uint64_t entropy[WORDS_IN_POOL];
+	/* index in bits of the first bit of usable entropy */
+	uint32_t entropy_bit_index;
+	/* then number of valid bits in the entropy pool */
+	uint32_t entropy_bit_size;
+	/* statistics, see trng_svc.h */
+	uint64_t stats[TRNG_STATS_TOTAL_IDS];
+} __aligned(CACHE_WRITEBACK_GRANULE);
 
-#define BITS_PER_WORD		(sizeof(entropy[0]) * 8)
+static struct trng_pool trng_pools[PLATFORM_CORE_COUNT];
+
+/* Lock serialising the calls to plat_get_entropy() */
+static spinlock_t trng_source_lock;
+
+#define BITS_PER_WORD		(sizeof(uint64_t) * 8)
 #define BITS_IN_POOL		(WORDS_IN_POOL * BITS_PER_WORD)
-#define ENTROPY_MIN_WORD	(entropy_bit_index / BITS_PER_WORD)
-#define ENTROPY_FREE_BIT	(entropy_bit_size + entropy_bit_index)
+#define ENTROPY_MIN_WORD	(pool->entropy_bit_index / BITS_PER_WORD)
+#define ENTROPY_FREE_BIT	(pool->entropy_bit_size + \
+				 pool->entropy_bit_index)
 #define _ENTROPY_FREE_WORD	(ENTROPY_FREE_BIT / BITS_PER_WORD)
 #define ENTROPY_FREE_INDEX	(_ENTROPY_FREE_WORD % WORDS_IN_POOL)
 /* ENTROPY_WORD_INDEX(0) includes leftover bits in the lower bits */
 #define ENTROPY_WORD_INDEX(i)	((ENTROPY_MIN_WORD + i) % WORDS_IN_POOL)
 
 /*
- * Fill the entropy pool until we have at least as many bits as requested.
- * Returns true after filling the pool, and false if the entropy source is out
- * of entropy and the pool could not be filled.
- * Assumes locks are taken.
+ * Number of bits below which the pool is topped up on entry into a power down
+ * state, so that the next TRNG_RND64 call of the largest size can be served
+ * without waiting for the entropy source.
+ */
+#define TRNG_POOL_LOW_WATERMARK	TRNG_RND64_ENTROPY_MAXBITS
+
+/*
+ * Fill the entropy pool of the calling CPU with as many words as it can hold.
+ * Returns true if the pool holds at least nbits afterwards, and false if the
+ * entropy source ran out of entropy before that.
  */
-static bool trng_fill_entropy(uint32_t nbits)
+static bool trng_fill_entropy(struct trng_pool *pool, uint32_t nbits)
 {
-	while (nbits > entropy_bit_size) {
-		bool valid = plat_get_entropy(&entropy[ENTROPY_FREE_INDEX]);
+	spin_lock(&trng_source_lock);
 
-		if (valid) {
-			entropy_bit_size += BITS_PER_WORD;
-			assert(entropy_bit_size <= BITS_IN_POOL);
-		} else {
-			return false;
+	/*
+	 * The first free bit is always word aligned, as bits are consumed from
+	 * the start of the valid ones, so a word can be added as long as there
+	 * is room for a whole word.
+	 */
+	while (pool->entropy_bit_size <= (BITS_IN_POOL - BITS_PER_WORD)) {
+		if (!plat_get_entropy(&pool->entropy[ENTROPY_FREE_INDEX])) {
+			break;
 		}
+		pool->entropy_bit_size += BITS_PER_WORD;
 	}
-	return true;
+
+	spin_unlock(&trng_source_lock);
+
+	return nbits <= pool->entropy_bit_size;
 }
 
 /*
- * Pack entropy into the out buffer, filling and taking locks as needed.
+ * Pack entropy into the out buffer, filling the pool as needed.
  * Returns true on success, false on failure.
  *
  * Note: out must have enough space for nbits of entropy
  */
 bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 {
-	bool ret = true;
+	struct trng_pool *pool = &trng_pools[plat_my_core_pos()];
 	uint32_t bits_to_discard = nbits;
-	spin_lock(&trng_pool_lock);
 
-	if (!trng_fill_entropy(nbits)) {
-		ret = false;
-		goto out;
+	if (nbits <= pool->entropy_bit_size) {
+		pool->stats[TRNG_STATS_HITS]++;
+	} else {
+		pool->stats[TRNG_STATS_STALLS]++;
+		if (!trng_fill_entropy(pool, nbits)) {
+			pool->stats[TRNG_STATS_FAILURES]++;
+			return false;
+		}
 	}
 
-	const unsigned int rshift = entropy_bit_index % BITS_PER_WORD;
+	const unsigned int rshift = pool->entropy_bit_index % BITS_PER_WORD;
 	const unsigned int lshift = BITS_PER_WORD - rshift;
 	const int to_fill = ((nbits + BITS_PER_WORD - 1) / BITS_PER_WORD);
 	int word_i;
@@ -111,7 +150,8 @@ bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 		 *                   5 4 3 2 1 0 7 6
 		 *                  [e,e,e,e,e,e,e,e]
 		 */
-		out[word_i] |= entropy[ENTROPY_WORD_INDEX(word_i)] >> rshift;
+		out[word_i] |=
+			pool->entropy[ENTROPY_WORD_INDEX(word_i)] >> rshift;
 
 		/**
 		 * Discarding the used/packed entropy bits from the respective
@@ -156,7 +196,7 @@ bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 		 * amount of bits only.
 		 */
 		if (bits_to_discard < (BITS_PER_WORD - rshift)) {
-			entropy[ENTROPY_WORD_INDEX(word_i)] &=
+			pool->entropy[ENTROPY_WORD_INDEX(word_i)] &=
 			(~0ULL << ((bits_to_discard+rshift) % BITS_PER_WORD));
 			bits_to_discard = 0;
 		} else {
@@ -167,7 +207,7 @@ bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 		 * will be already zeros from previous operations, and the
 		 * bits_to_discard is updated precisely.
 		 */
-			entropy[ENTROPY_WORD_INDEX(word_i)] = 0;
+			pool->entropy[ENTROPY_WORD_INDEX(word_i)] = 0;
 			bits_to_discard -= (BITS_PER_WORD - rshift);
 		}
 
@@ -178,7 +218,8 @@ bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 		 * the `|=` operation.
 		 */
 		if (lshift != BITS_PER_WORD) {
-			out[word_i] |= entropy[ENTROPY_WORD_INDEX(word_i + 1)]
+			out[word_i] |=
+				pool->entropy[ENTROPY_WORD_INDEX(word_i + 1)]
 				<< lshift;
 			/**
 			 * Discarding the remaining packed bits from upperword
@@ -191,7 +232,7 @@ bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 			 * amount of bits only.
 			 */
 			if (bits_to_discard < (BITS_PER_WORD - lshift)) {
-				entropy[ENTROPY_WORD_INDEX(word_i+1)]  &=
+				pool->entropy[ENTROPY_WORD_INDEX(word_i+1)]  &=
 				(~0ULL << ((bits_to_discard) % BITS_PER_WORD));
 				bits_to_discard = 0;
 			} else {
@@ -204,7 +245,7 @@ bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 			 * there are still some unused valid entropy bits at the
 			 * upper end for future use.
 			 */
-				entropy[ENTROPY_WORD_INDEX(word_i+1)]  &=
+				pool->entropy[ENTROPY_WORD_INDEX(word_i+1)]  &=
 				(~0ULL << ((BITS_PER_WORD - lshift) % BITS_PER_WORD));
 				bits_to_discard -= (BITS_PER_WORD - lshift);
 		}
@@ -215,22 +256,63 @@ bool trng_pack_entropy(uint32_t nbits, uint64_t *out)
 
 	out[to_fill - 1] &= mask;
 
-	entropy_bit_index = (entropy_bit_index + nbits) % BITS_IN_POOL;
-	entropy_bit_size -= nbits;
+	pool->entropy_bit_index = (pool->entropy_bit_index + nbits) %
+				  BITS_IN_POOL;
+	pool->entropy_bit_size -= nbits;
 
-out:
-	spin_unlock(&trng_pool_lock);
+	return true;
+}
+
+/*
+ * Top up the entropy pool of the calling CPU if it runs low, so that the
+ * latency of the entropy source is paid while the CPU has nothing else to do
+ * rather than by the next TRNG_RND caller. This runs before the PSCI locks
+ * are taken, so the other CPUs of the power domain do not wait for the
+ * source.
+ */
+static void *trng_suspend_pwrdown_prepare(const void *arg)
+{
+	struct trng_pool *pool = &trng_pools[plat_my_core_pos()];
+
+	if (pool->entropy_bit_size < TRNG_POOL_LOW_WATERMARK) {
+		pool->stats[TRNG_STATS_PREFILLS]++;
+		(void)trng_fill_entropy(pool, 0U);
+	}
 
-	return ret;
+	return (void *)0;
 }
 
+SUBSCRIBE_TO_EVENT(psci_suspend_pwrdown_prepare,
+		   trng_suspend_pwrdown_prepare);
+
 void trng_entropy_pool_setup(void)
 {
+	unsigned int cpu;
 	int i;
 
-	for (i = 0; i < WORDS_IN_POOL; i++) {
-		entropy[i] = 0;
+	for (cpu = 0U; cpu < PLATFORM_CORE_COUNT; cpu++) {
+		for (i = 0; i < WORDS_IN_POOL; i++) {
+			trng_pools[cpu].entropy[i] = 0;
+		}
+		trng_pools[cpu].entropy_bit_index = 0;
+		trng_pools[cpu].entropy_bit_size = 0;
 	}
-	entropy_bit_index = 0;
-	entropy_bit_size = 0;
 }
+
+#if ENABLE_PMF
+/* PMF handler returning a statistic of the pool of a CPU, see trng_svc.h */
+static unsigned long long trng_stats_get(unsigned int tid, u_register_t mpidr,
+					 unsigned int flags)
+{
+	int cpu = plat_core_pos_by_mpidr(mpidr);
+
+	/* The PMF framework already checked both */
+	assert((cpu >= 0) && ((tid & PMF_TID_MASK) < TRNG_STATS_TOTAL_IDS));
+
+	return trng_pools[cpu].stats[tid & PMF_TID_MASK];
+}
+
+PMF_REGISTER_SERVICE_SMC_OWN(trng_stats, PMF_ARM_TIF_IMPL_ID,
+			     PMF_TRNG_STATS_SVC_ID, TRNG_STATS_TOTAL_IDS,
+			     NULL, trng_stats_get)
+#endif /* ENABLE_PMF */
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2023, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+"""Decode a dump of the BL31 trace log.
+
+The trace buffer only holds the offsets of the format strings of the events in
+the .trace_fmt section of the BL31 ELF file, along with the raw values of their
+arguments. This script rebuilds the messages from both, e.g.:
+
+    trace_log_decode.py build/fvp/debug/bl31/bl31.elf trace.bin --freq 100000000
+
+where trace.bin is a copy of /dev/trace from debugfs, or a memory dump of the
+trace_log_buffer symbol.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+from elftools.elf.constants import SH_FLAGS
+from elftools.elf.elffile import ELFFile
+
+TRACE_LOG_MAGIC = 0x4C544654
+TRACE_LOG_VERSION = 1
+
+HEADER = struct.Struct("<6I")
+ENTRY_FIXED = struct.Struct("<QQII")
+
+# printf() conversion specifications supported by the TF-A libc
+CONVERSION = re.compile(
+    r"%(?P<flags>[-+ 0#]*)(?P<width>\d*)(?:\.(?P<prec>\d+))?"
+    r"(?P<length>hh|h|ll|l|z|j|t)?(?P<conv>[diuxXpcs%])"
+)
+
+
+class TraceImage:
+    """Format strings and read-only data of a BL31 ELF file."""
+
+    def __init__(self, elf_file):
+        elf = ELFFile(elf_file)
+
+        section = elf.get_section_by_name(".trace_fmt")
+        if section is None:
+            sys.exit("error: no .trace_fmt section, is ENABLE_TRACE_LOG set?")
+        self.formats = section.data()
+
+        self.loaded = [
+            (s["sh_addr"], s.data())
+            for s in elf.iter_sections()
+            if (s["sh_flags"] & SH_FLAGS.SHF_ALLOC) and s["sh_type"] != "SHT_NOBITS"
+        ]
+
+    def format_string(self, fmt_id):
+        end = self.formats.find(b"\0", fmt_id)
+        if fmt_id >= len(self.formats) or end < 0:
+            return None
+        return self.formats[fmt_id:end].decode(errors="replace")
+
+    def string_at(self, addr):
+        for base, data in self.loaded:
+            if base <= addr < base + len(data):
+                end = data.find(b"\0", addr - base)
+                if end >= 0:
+                    return data[addr - base : end].decode(errors="replace")
+        return "<0x%x>" % addr
+
+
+def format_event(image, fmt, args):
+    """Format an event the way printf() would have."""
+    args = list(args)
+
+    def convert(match):
+        conv = match.group("conv")
+        if conv == "%":
+            return "%"
+        value = args.pop(0) if args else 0
+        length = match.group("length") or ""
+        bits = 64 if length in ("l", "ll", "z", "j", "t") else 32
+
+        spec = "%" + match.group("flags") + match.group("width")
+        if match.group("prec"):
+            spec += "." + match.group("prec")
+
+        if conv == "s":
+            return (spec + "s") % image.string_at(value)
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "p":
+            return "0x%x" % value
+
+        value &= (1 << bits) - 1
+        if conv in "di" and value >= 1 << (bits - 1):
+            value -= 1 << bits
+        return (spec + {"i": "d", "u": "d"}.get(conv, conv)) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def read_events(dump):
+    """Return the events of all CPUs as (timestamp, cpu, seq, fmt_id, args)."""
+    magic, version, cpu_count, entries, entry_size, max_args = HEADER.unpack_from(dump)
+    if magic != TRACE_LOG_MAGIC:
+        sys.exit("error: bad trace log magic 0x%x" % magic)
+    if version != TRACE_LOG_VERSION:
+        sys.exit("error: unsupported trace log version %d" % version)
+
+    args_fmt = struct.Struct("<%dQ" % max_args)
+    events = []
+
+    for cpu in range(cpu_count):
+        for index in range(entries):
+            offset = HEADER.size + (cpu * entries + index) * entry_size
+            if offset + entry_size > len(dump):
+                break
+            timestamp, fmt_id, seq, nargs = ENTRY_FIXED.unpack_from(dump, offset)
+            if seq == 0:
+                # Unused, or being written when the dump was taken
+                continue
+            args = args_fmt.unpack_from(dump, offset + ENTRY_FIXED.size)
+            events.append((timestamp, cpu, seq, fmt_id, args[: min(nargs, max_args)]))
+
+    return sorted(events)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", type=argparse.FileType("rb"), help="BL31 ELF file")
+    parser.add_argument("dump", type=argparse.FileType("rb"), help="trace buffer dump")
+    parser.add_argument(
+        "--freq",
+        type=int,
+        default=0,
+        help="system counter frequency in Hz, to print times in microseconds",
+    )
+    args = parser.parse_args()
+
+    image = TraceImage(args.elf)
+    events = read_events(args.dump.read())
+    if not events:
+        return
+
+    start = events[0][0]
+    for timestamp, cpu, seq, fmt_id, values in events:
+        fmt = image.format_string(fmt_id)
+        if fmt is None:
+            message = "<unknown event 0x%x>\n" % fmt_id
+        else:
+            message = format_event(image, fmt, values)
+
+        if args.freq:
+            stamp = "%12.3f" % ((timestamp - start) * 1e6 / args.freq)
+        else:
+            stamp = "%12d" % (timestamp - start)
+
+        sys.stdout.write("[%s] cpu%-3d %s" % (stamp, cpu, message))
+        if not message.endswith("\n"):
+            sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()